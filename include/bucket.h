@@ -6,6 +6,11 @@
  * bucket implementation for variants of bucket cuckoo hashing.
  * This implementation ensures that all contained elements are stored in the
  * beginning of the bucket. This allows some performance tricks.
+ * Empty slots hold key_type(), thus, a bucket of 8 pairs of 8 byte values
+ * fills exactly two cache lines. The tables keep an element with key
+ * key_type() in their stash (see cuckoo_base). Keys are compared through
+ * probe_kernel (bucket_simd.h), which checks all slots at once.
+ * With D = void the bucket stores only keys (see element.h).
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -14,7 +19,12 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <cstdint>
 #include <tuple>
+#include <utility>
+
+#include "element.h"
+#include "bucket_simd.h"
 
 namespace dysect
 {
@@ -23,12 +33,17 @@ namespace dysect
     class bucket
     {
     public:
-        using key_type    = K;
-        using mapped_type = D;
+        using key_type         = K;
+        using mapped_type      = D;
+        using value_intern     = typename element_traits<K,D>::value_intern;
+        using mapped_param_type = typename element_traits<K,D>::mapped_param_type;
+        using find_return_type = std::pair<bool, mapped_type>;
+        static constexpr size_t bs = BS;
+        // key_type() marks empty slots (it cannot be stored)
+        static constexpr bool empty_key = true;
     private:
-        using value_intern     = std::pair<key_type,mapped_type>;
+        using kernel_type      = probe_kernel<key_type, value_intern, BS>;
     public:
-        using find_return_type = std::pair<bool, mapped_type>;
 
         bucket()
         {
@@ -38,190 +53,170 @@ namespace dysect
         bucket(const bucket& rhs) = default;
         bucket& operator=(const bucket& rhs) = default;
 
-        bool   insert(const key_type& k, const mapped_type& d);
+        bool   insert(const key_type& k, const mapped_param_type& d);
         bool   insert(const value_intern& t);
         find_return_type   find  (const key_type& k);
-        bool   remove(const key_type& k);
+        template<class LKey>
+        bool   remove(const LKey& k);
+        void   remove_at(const size_t i);
         find_return_type   pop   (const key_type& k);
 
         int    probe (const key_type& k);
 
         bool   space ();
         value_intern get(const size_t i);
-        value_intern replace(const size_t i, const value_intern& t);
+        value_intern replace(const size_t i, value_intern t);
 
 
-        value_intern* insert_ptr(const value_intern& t);
-        const value_intern* find_ptr(const key_type& k) const;
-        value_intern* find_ptr(const key_type& k);
+        value_intern* insert_ptr(value_intern t);
+        template<class LKey>
+        const value_intern* find_ptr(const LKey& k) const;
+        template<class LKey>
+        value_intern* find_ptr(const LKey& k);
         std::pair<int, value_intern*> probe_ptr(const key_type& k);
 
+        bool   occupied(const size_t i) const { return elements[i].first != key_type(); }
+        size_t size() const { return kernel_type::find(elements, key_type(), BS); }
+
+        // Hashed interface used by the tables (common to all bucket types),
+        // this bucket does not use the hash.  Lookups take any key type
+        // comparable to key_type (heterogeneous lookup, see hasher.h).
+        template<class LKey, class Hashed>
+        value_intern* find_ptr (const LKey& k, const Hashed&)       { return find_ptr(k); }
+        template<class LKey, class Hashed>
+        const value_intern* find_ptr (const LKey& k, const Hashed&) const { return find_ptr(k); }
+        template<class Hashed>
+        std::pair<int, value_intern*> probe_ptr(const key_type& k, const Hashed&) { return probe_ptr(k); }
+        template<class Hashed>
+        value_intern* insert_ptr(value_intern t, const Hashed&)  { return insert_ptr(std::move(t)); }
+        template<class LKey, class Hashed>
+        bool   remove (const LKey& k, const Hashed&)                    { return remove(k); }
+        template<class Hashed>
+        value_intern replace(const size_t i, value_intern t, const Hashed&)
+        { return replace(i, std::move(t)); }
+
         value_intern elements[BS];
+
+    private:
+        template<class LKey>
+        using lookup_kernel_type = lookup_kernel<LKey, key_type, value_intern, BS>;
     };
 
 
     template<class K, class D, size_t BS>
-    inline bool bucket<K,D,BS>::insert(const key_type& k, const mapped_type& d)
+    inline bool bucket<K,D,BS>::insert(const key_type& k, const mapped_param_type& d)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (elements[i].first) continue;
-            elements[i].first  = k;
-            elements[i].second = d;
-
-            return true;
-        }
-
-        return false;
+        return insert_ptr(element_traits<K,D>::make(k, d)) != nullptr;
     }
 
     template<class K, class D, size_t BS>
     inline bool bucket<K,D,BS>::insert(const value_intern& t)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (elements[i].first) continue;
-
-            elements[i]  = t;
-            return true;
-        }
-
-        return false;
+        return insert_ptr(t) != nullptr;
     }
 
     template<class K, class D, size_t BS>
     inline typename bucket<K,D,BS>::find_return_type bucket<K,D,BS>::find(const key_type& k)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (!elements[i].first )      return std::make_pair(false, mapped_type());
-            if ( elements[i].first == k ) return std::make_pair(true, elements[i].second);
-        }
+        auto ptr = find_ptr(k);
+        if (ptr) return std::make_pair(true, ptr->second);
         return std::make_pair(false, mapped_type());
     }
 
+    template<class K, class D, size_t BS> template<class LKey>
+    inline bool bucket<K,D,BS>::remove(const LKey& k)
+    {
+        size_t i = lookup_kernel_type<LKey>::find(elements, k, BS);
+        if (i == BS) return false;
+
+        remove_at(i);
+        return true;
+    }
+
     template<class K, class D, size_t BS>
-    inline bool bucket<K,D,BS>::remove(const key_type& k)
+    inline void bucket<K,D,BS>::remove_at(const size_t i)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (elements[i].first == k)
-            {
-                size_t j = BS-1;
-                for ( ; !elements[j].first; --j ) { }
-                elements[i] = elements[j];
-                elements[j] = std::make_pair(key_type(), mapped_type());
-                return true;
-            }
-            else if (! elements[i].first)
-            {
-                break;
-            }
-        }
-        return false;
+        size_t j = size() - 1;
+        elements[i] = std::move(elements[j]);
+        elements[j] = value_intern();
     }
 
     template<class K, class D, size_t BS>
     inline typename bucket<K,D,BS>::find_return_type bucket<K,D,BS>::pop(const key_type& k)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (elements[i].first == k)
-            {
-                mapped_type d = elements[i].second;
-                for (size_t j = i+1; j < BS; ++j)
-                {
-                    if (elements[j].first) { elements[i] = elements[j]; i = j; }
-                    else break;
-                }
-                elements[i] = std::make_pair(key_type(), mapped_type());
-                return std::make_pair(true, d);
-            }
-            else if (! elements[i].first)
-            {
-                break;
-            }
-        }
-        return std::make_pair(false, mapped_type());
+        size_t i = kernel_type::find(elements, k, BS);
+        if (i == BS) return std::make_pair(false, mapped_type());
+
+        mapped_type d = elements[i].second;
+        size_t j = size() - 1;
+        for (; i < j; ++i) elements[i] = elements[i+1];
+        elements[j] = value_intern();
+        return std::make_pair(true, d);
     }
 
     template<class K, class D, size_t BS>
     inline int bucket<K,D,BS>::probe(const key_type& k)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (!elements[i].first)      return BS - i;
-            if ( elements[i].first == k) return -1;
-
-        }
-        return 0;
+        if (kernel_type::find(elements, k, BS) < BS) return -1;
+        return BS - size();
     }
 
     template<class K, class D, size_t BS>
     inline bool bucket<K,D,BS>::space()
     {
-        return !elements[BS-1].first;
+        return elements[BS-1].first == key_type();
     }
 
     template<class K, class D, size_t BS>
-    inline std::pair<K, D> bucket<K,D,BS>::get(size_t i)
+    inline typename bucket<K,D,BS>::value_intern bucket<K,D,BS>::get(size_t i)
     {
         return elements[i];
     }
 
     template<class K, class D, size_t BS>
-    inline std::pair<K, D> bucket<K,D,BS>::replace(size_t i, const value_intern& newE)
+    inline typename bucket<K,D,BS>::value_intern
+    bucket<K,D,BS>::replace(size_t i, value_intern newE)
     {
-        auto temp = elements[i];
-        elements[i] = newE;
+        auto temp = std::move(elements[i]);
+        elements[i] = std::move(newE);
         return temp;
     }
 
 
     template<class K, class D, size_t BS>
-    inline std::pair<K,D>* bucket<K,D,BS>::insert_ptr(const value_intern& t)
+    inline typename bucket<K,D,BS>::value_intern* bucket<K,D,BS>::insert_ptr(value_intern t)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (elements[i].first) continue;
-
-            elements[i]  = t;
-            return &elements[i];
-        }
+        size_t i = size();
+        if (i == BS) return nullptr;
 
-        return nullptr;
+        elements[i]  = std::move(t);
+        return &elements[i];
     }
 
-    template<class K, class D, size_t BS>
-    inline std::pair<K,D>* bucket<K,D,BS>::find_ptr(const key_type& k)
+    template<class K, class D, size_t BS> template<class LKey>
+    inline typename bucket<K,D,BS>::value_intern* bucket<K,D,BS>::find_ptr(const LKey& k)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            //if (!elements[i].first )      return nullptr;
-            if ( elements[i].first == k ) return &elements[i];
-        }
+        size_t i = lookup_kernel_type<LKey>::find(elements, k, BS);
+        if (i < BS) return &elements[i];
         return nullptr;
     }
 
-    template<class K, class D, size_t BS>
-    inline const std::pair<K,D>* bucket<K,D,BS>::find_ptr(const key_type& k) const
+    template<class K, class D, size_t BS> template<class LKey>
+    inline const typename bucket<K,D,BS>::value_intern* bucket<K,D,BS>::find_ptr(const LKey& k) const
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            //if (!elements[i].first )      return nullptr;
-            if ( elements[i].first == k ) return &elements[i];
-        }
+        size_t i = lookup_kernel_type<LKey>::find(elements, k, BS);
+        if (i < BS) return &elements[i];
         return nullptr;
     }
 
     template<class K, class D, size_t BS>
-    inline std::pair<int, std::pair<K,D>*> bucket<K,D,BS>::probe_ptr(const key_type& k)
+    inline std::pair<int, typename bucket<K,D,BS>::value_intern*>
+    bucket<K,D,BS>::probe_ptr(const key_type& k)
     {
-        for (size_t i = 0; i < BS; ++i)
-        {
-            if (!elements[i].first)      return std::make_pair(BS - i, &elements[i]);
-            if ( elements[i].first == k) return std::make_pair(-1    , &elements[i]);
-        }
+        size_t i = kernel_type::find(elements, k, BS);
+        if (i < BS) return std::make_pair(-1, &elements[i]);
+        size_t j = size();
+        if (j < BS) return std::make_pair(int(BS - j), &elements[j]);
         return std::make_pair(0, nullptr);
     }
 
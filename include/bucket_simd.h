@@ -0,0 +1,164 @@
+#pragma once
+
+/*******************************************************************************
+ * include/bucket_simd.h
+ *
+ * probe_kernel implements the key comparisons of a packed bucket (all
+ * elements stored at its front, empty slots hold key_type()).
+ * 8 byte integral keys are compared with SSE4.1 or AVX2, all other
+ * element types use a scalar fallback.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace dysect
+{
+
+    // SCALAR FALLBACK *********************************************************
+
+    // find(e, k, n) returns the index of k among the first n slots (BS if
+    // it is not contained)
+    template<class K, class E, size_t BS, class Enable = void>
+    struct probe_kernel
+    {
+        static inline size_t find(const E* e, const K& k, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (e[i].first == k) return i;
+            }
+            return BS;
+        }
+    };
+
+
+
+    // VECTORIZED (8 BYTE KEYS IN 8 OR 16 BYTE ELEMENTS) **********************
+#if defined(__SSE4_1__) || defined(__AVX2__)
+
+    // keys next to 8 byte values are deinterleaved in registers (two slots
+    // per SSE4.1, four per AVX2 instruction), keys of sets are contiguous
+    template<class K, class E, size_t BS>
+    struct probe_kernel_vectorizable
+    {
+        static constexpr bool value = std::is_integral<K>::value
+                                   && sizeof(K) == 8
+                                   && (sizeof(E) == 16 || sizeof(E) == 8)
+#if defined(__AVX2__)
+                                   && BS % 4 == 0;
+#else
+                                   && BS % 2 == 0;
+#endif
+    };
+
+    template<class K, class E, size_t BS>
+    struct probe_kernel<K, E, BS,
+                        typename std::enable_if<probe_kernel_vectorizable<K,E,BS>::value>::type>
+    {
+        using mask_type    = uint64_t;
+
+        // the lowest matching slot (e.g. the first empty slot of a bucket)
+        static inline size_t find(const E* e, const K& k, size_t n)
+        {
+            mask_type hit = in_order(matches(e, k, n)) & low(n);
+            return hit ? __builtin_ctzll(hit) : BS;
+        }
+
+    private:
+        // elements without data, keys are contiguous
+        static constexpr bool key_only = sizeof(E) == sizeof(K);
+
+        // bit j represents slot(j), only groups containing the first n slots are read
+        static inline mask_type matches(const E* e, const K& k, size_t n)
+        {
+            mask_type h = 0;
+#if defined(__AVX2__)
+            const __m256i vk = _mm256_set1_epi64x(int64_t(k));
+            for (size_t i = 0; i < n; i += 4)
+            {
+                __m256i keys;
+                if (key_only)
+                {
+                    keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e+i));
+                }
+                else
+                {
+                    // a = k0 d0 | k1 d1,  b = k2 d2 | k3 d3  =>  keys = k0 k2 | k1 k3
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e+i));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e+i+2));
+                    keys      = _mm256_unpacklo_epi64(a, b);
+                }
+                h |= mask_type(_mm256_movemask_pd(
+                          _mm256_castsi256_pd(_mm256_cmpeq_epi64(keys, vk)))) << i;
+            }
+#else
+            const __m128i vk = _mm_set1_epi64x(int64_t(k));
+            for (size_t i = 0; i < n; i += 2)
+            {
+                __m128i keys;
+                if (key_only)
+                {
+                    keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(e+i));
+                }
+                else
+                {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(e+i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(e+i+1));
+                    keys      = _mm_unpacklo_epi64(a, b);
+                }
+                h |= mask_type(_mm_movemask_pd(
+                          _mm_castsi128_pd(_mm_cmpeq_epi64(keys, vk)))) << i;
+            }
+#endif
+            return h;
+        }
+
+        // bit i represents slot i afterwards
+        static inline mask_type in_order(mask_type h)
+        {
+#if defined(__AVX2__)
+            if (key_only) return h;
+            // the avx2 unpack leaves the keys of four slots in the order 0 2 1 3
+            return (h & 0x9999999999999999ull)
+                | ((h & 0x2222222222222222ull) << 1)
+                | ((h & 0x4444444444444444ull) >> 1);
+#else
+            return h;
+#endif
+        }
+
+        static inline mask_type low(size_t n)
+        {
+            return (n >= 64) ? ~mask_type(0) : (mask_type(1) << n) - 1;
+        }
+    };
+
+#endif // __SSE4_1__ || __AVX2__
+
+
+
+    // HETEROGENEOUS LOOKUP ****************************************************
+
+    // lookup keys of another type than the stored keys always use the
+    // scalar fallback
+    struct scalar_probe { };
+
+    template<class LK, class K, class E, size_t BS>
+    using lookup_kernel = typename std::conditional<std::is_same<LK, K>::value,
+                                                    probe_kernel<K,  E, BS>,
+                                                    probe_kernel<LK, E, BS, scalar_probe> >::type;
+
+} // namespace dysect
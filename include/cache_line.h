@@ -0,0 +1,127 @@
+#pragma once
+
+/*******************************************************************************
+ * include/cache_line.h
+ *
+ * Helpers to place buckets on cache lines:
+ *  - make_aligned_array/make_aligned_buffer allocate cache line aligned
+ *    bucket arrays (std::make_unique and operator new only guarantee
+ *    16 byte alignment)
+ *  - cache_line_slots computes the number of slots, s.t. one bucket fills
+ *    one (if it holds at least 4 slots) or two cache lines, and
+ *    cache_aligned pads such a bucket to exactly these lines
+ *    (see cuckoo_config<0, ...>)
+ *  - prefetch_lines prefetches all cache lines of one bucket (used for
+ *    batched operations)
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "hashed_bucket.h"
+
+namespace dysect
+{
+
+    static constexpr size_t cache_line_size = 64;
+
+
+
+    // ALIGNED ALLOCATION ******************************************************
+
+    // frees aligned memory, destroys the first n elements
+    template<class T>
+    struct aligned_deleter
+    {
+        size_t n = 0;
+
+        void operator()(T* ptr) const
+        {
+            for (size_t i = 0; i < n; ++i) ptr[i].~T();
+            free(ptr);
+        }
+    };
+
+    template<class T>
+    using aligned_array = std::unique_ptr<T[], aligned_deleter<T> >;
+
+    // uninitialized memory, e.g. overallocated tables, that are
+    // initialized piece by piece
+    template<class T>
+    aligned_array<T> make_aligned_buffer(size_t bytes)
+    {
+        void* mem = nullptr;
+        if (posix_memalign(&mem, cache_line_size, bytes)) throw std::bad_alloc();
+        return aligned_array<T>(static_cast<T*>(mem));
+    }
+
+    // n value initialized elements
+    template<class T>
+    aligned_array<T> make_aligned_array(size_t n)
+    {
+        auto result = make_aligned_buffer<T>(n*sizeof(T));
+        for (size_t i = 0; i < n; ++i) new (result.get()+i) T();
+        result.get_deleter().n = n;
+        return result;
+    }
+
+
+
+    // CACHE LINE SIZED BUCKETS ************************************************
+
+    template<class Bucket>
+    class alignas(cache_line_size) cache_aligned : public Bucket
+    {
+    public:
+        cache_aligned() : Bucket() { }
+    };
+
+    template<class Bucket>
+    struct slot_hash<cache_aligned<Bucket> > : public slot_hash<Bucket>
+    { };
+
+    // largest number of slots (starting from B) that fits into Bytes
+    template<class Conf, class K, class D, class H, size_t Bytes, size_t B = 1,
+             bool Fits = (B < 64) &&
+             (sizeof(typename Conf::template packed_bucket_type<K,D,B+1,H>) <= Bytes)>
+    struct max_slots
+    {
+        static constexpr size_t value = max_slots<Conf,K,D,H,Bytes,B+1>::value;
+    };
+
+    template<class Conf, class K, class D, class H, size_t Bytes, size_t B>
+    struct max_slots<Conf,K,D,H,Bytes,B,false>
+    {
+        static constexpr size_t value = B;
+    };
+
+    template<class Conf, class K, class D, class H>
+    struct cache_line_slots
+    {
+        static constexpr size_t one_line  = max_slots<Conf,K,D,H,  cache_line_size>::value;
+        static constexpr size_t two_lines = max_slots<Conf,K,D,H,2*cache_line_size>::value;
+        static constexpr size_t value     = (one_line >= 4) ? one_line : two_lines;
+    };
+
+
+
+    // PREFETCHING *************************************************************
+
+    // prefetches all cache lines touched by *ptr
+    template<class T>
+    inline void prefetch_lines(const T* ptr)
+    {
+        const char* mem = reinterpret_cast<const char*>(ptr);
+        for (size_t off = 0; off < sizeof(T); off += cache_line_size)
+            __builtin_prefetch(mem + off);
+        __builtin_prefetch(mem + sizeof(T) - 1);
+    }
+
+} // namespace dysect
@@ -6,7 +6,8 @@
  * co_bucket is the bucket implementation for variants that use overlapping
  * buckets. Contrary to bucket, co_bucket does not ensure that all contained
  * elements are stored in the beginning of the bucket. Therefore, some
- * improvements are not possible.
+ * improvements are not possible.  Key 0 marks empty slots, cuckoo_base
+ * keeps an element with key 0 in its stash (see is_empty_key).
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -28,11 +29,11 @@ namespace dysect
     public:
         using key_type         = K;
         using mapped_type      = D;
-
-    private:
         using value_intern     = std::pair<key_type,mapped_type>;
-    public:
         using find_return_type = std::pair<bool, mapped_type>;
+        static constexpr size_t bs = BS;
+        // key_type() marks empty slots (it cannot be stored)
+        static constexpr bool empty_key = true;
 
         co_bucket()
         {
@@ -45,7 +46,9 @@ namespace dysect
         bool             insert(const key_type& k, const mapped_type& d);
         bool             insert(const value_intern& t);
         find_return_type find  (const key_type& k);
-        bool             remove(const key_type& k);
+        template<class LKey>
+        bool             remove(const LKey& k);
+        void             remove_at(const size_t i);
         find_return_type pop   (const key_type& k);
 
         int              probe (const key_type& k);
@@ -56,10 +59,30 @@ namespace dysect
 
 
         value_intern*    insert_ptr(const value_intern& t);
-        const value_intern* find_ptr(const key_type& k) const;
-        value_intern*    find_ptr(const key_type& k);
+        template<class LKey>
+        const value_intern* find_ptr(const LKey& k) const;
+        template<class LKey>
+        value_intern*    find_ptr(const LKey& k);
         std::pair<int, value_intern*> probe_ptr(const key_type& k);
 
+        bool occupied(const size_t i) const { return elements[i].first != key_type(); }
+
+        // Hashed interface used by the tables (common to all bucket types),
+        // this bucket does not use the hash.
+        template<class LKey, class Hashed>
+        value_intern* find_ptr (const LKey& k, const Hashed&)       { return find_ptr(k); }
+        template<class LKey, class Hashed>
+        const value_intern* find_ptr (const LKey& k, const Hashed&) const { return find_ptr(k); }
+        template<class Hashed>
+        std::pair<int, value_intern*> probe_ptr(const key_type& k, const Hashed&) { return probe_ptr(k); }
+        template<class Hashed>
+        value_intern* insert_ptr(const value_intern& t, const Hashed&)  { return insert_ptr(t); }
+        template<class LKey, class Hashed>
+        bool remove (const LKey& k, const Hashed&)                      { return remove(k); }
+        template<class Hashed>
+        value_intern replace(const size_t i, const value_intern& t, const Hashed&)
+        { return replace(i, t); }
+
         value_intern elements[BS];
     };
 
@@ -104,8 +127,8 @@ namespace dysect
         return std::make_pair(false, mapped_type());
     }
 
-    template<class K, class D, size_t BS>
-    inline bool co_bucket<K,D,BS>::remove(const key_type& k)
+    template<class K, class D, size_t BS> template<class LKey>
+    inline bool co_bucket<K,D,BS>::remove(const LKey& k)
     {
         for (size_t i = 0; i < BS; ++i)
         {
@@ -118,6 +141,12 @@ namespace dysect
         return false;
     }
 
+    template<class K, class D, size_t BS>
+    inline void co_bucket<K,D,BS>::remove_at(const size_t i)
+    {
+        elements[i] = std::make_pair(key_type(), mapped_type());
+    }
+
     template<class K, class D, size_t BS>
     inline typename co_bucket<K,D,BS>::find_return_type
     co_bucket<K,D,BS>::pop(const key_type& k)
@@ -188,9 +217,9 @@ namespace dysect
         return nullptr;
     }
 
-    template<class K, class D, size_t BS>
+    template<class K, class D, size_t BS> template<class LKey>
     inline std::pair<K,D>*
-    co_bucket<K,D,BS>::find_ptr(const key_type& k)
+    co_bucket<K,D,BS>::find_ptr(const LKey& k)
     {
         for (size_t i = 0; i < BS; ++i)
         {
@@ -199,9 +228,9 @@ namespace dysect
         return nullptr;
     }
 
-    template<class K, class D, size_t BS>
+    template<class K, class D, size_t BS> template<class LKey>
     inline const std::pair<K,D>*
-    co_bucket<K,D,BS>::find_ptr(const key_type& k) const
+    co_bucket<K,D,BS>::find_ptr(const LKey& k) const
     {
         for (size_t i = 0; i < BS; ++i)
         {
@@ -7,7 +7,10 @@
  * hashing.  Implemented functions include insert, find, erase ... .
  * Inheriting classes only have to implement the get bucket functions
  * (and Specialize CuckooTraits, iterator_incrr).  CRTP is used to
- * eliminate vtable lookups.
+ * eliminate vtable lookups.  Failed displacements are stashed (see
+ * set_stash_size) or rehash the table with new hash functions.  Buckets
+ * that mark empty slots with key_type() cannot store this key, its
+ * element is always kept in the stash.
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -16,15 +19,24 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <limits>
+#include <random>
+#include <type_traits>
 
 #include "bucket.h"
+#include "tag_bucket.h"
+#include "hashed_bucket.h"
+#include "cache_line.h"
 #include "hasher.h"
 #include "iterator_base.h"
+#include "table_stats.h"
+#include "latency_count.h"
 #include "displacement_strategies/main_strategies.h"
 
 // CRTP base class for all cuckoo tables, this encapsulates
@@ -56,6 +68,18 @@ namespace dysect
     template<class T>
     class iterator_incr;
 
+    // displacement strategies that use the subtable fill counters define
+    // static constexpr bool uses_fill = true
+    template<class DisStrat, class = void>
+    struct uses_fill : std::false_type { };
+
+    template<class DisStrat>
+    struct uses_fill<DisStrat, typename std::enable_if<DisStrat::uses_fill>::type>
+        : std::true_type { };
+
+    template<class Inner>
+    class stash_incr;
+
     class hist_count
     {
     public:
@@ -64,6 +88,29 @@ namespace dysect
 
         void add(size_t i) { auto ind = (i<steps) ? i:steps-1; ++hist[ind];}
 
+        size_t count() const
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < steps; ++i) sum += hist[i];
+            return sum;
+        }
+
+        // smallest number of steps, s.t. a fraction q of all insertions
+        // needed at most that many (steps-1 includes all longer paths)
+        size_t percentile(double q) const
+        {
+            size_t total = count();
+            if (!total) return 0;
+            size_t rank = std::max<size_t>(1, size_t(q * double(total) + .5));
+            size_t sum  = 0;
+            for (size_t i = 0; i < steps; ++i)
+            {
+                sum += hist[i];
+                if (sum >= rank) return i;
+            }
+            return steps-1;
+        }
+
         const size_t steps;
         std::unique_ptr<size_t[]> hist;
     };
@@ -73,24 +120,57 @@ namespace dysect
     public:
         no_hist_count(size_t = 0) { }
         void add(size_t) { }
+        size_t count() const { return 0; }
+        size_t percentile(double) const { return 0; }
         static constexpr size_t  steps = 0;
         static constexpr size_t* hist  = nullptr;
     };
 
     template<size_t BS = 8, size_t NH = 3, size_t TL = 256,
              template <class> class DisStrat = cuckoo_displacement::trivial,
-             class HistCount = no_hist_count>
+             class HistCount = no_hist_count,
+             template <class, class, size_t> class Bucket = bucket,
+             bool StoreHash = false,
+             class LatencyCount = no_latency_count,
+             bool PrimaryFirst = false>
     struct cuckoo_config
     {
-        static constexpr size_t bs = BS;
+        static constexpr size_t bs = BS; // 0 = fill cache lines (see slots)
         static constexpr size_t tl = TL;
         static constexpr size_t nh = NH;
         static constexpr size_t sbs = 4;
 
+        // placement policy, new elements go into the emptiest of their
+        // buckets (false), or into the first bucket with space (true),
+        // then most finds (buckets are probed in order) touch one bucket
+        static constexpr bool primary_first = PrimaryFirst;
+
         template <class T>
         using dis_strat_type  = DisStrat<T>;
 
+        // instrumentation (free when disabled): path length histograms
+        // and per operation latencies (see latency_count.h)
         using hist_count_type = HistCount;
+        using latency_count_type = LatencyCount;
+
+        // bucket layout (bucket or tag_bucket), StoreHash keeps the hashed
+        // value of each element (hashed_bucket); only used by the
+        // cuckoo_standard, cuckoo_dysect, and cuckoo_deamortized variants
+        template <class K, class D, size_t B, class Hashed>
+        using packed_bucket_type = typename std::conditional<StoreHash,
+                                       hashed_bucket<Bucket<K,D,B>, Hashed>,
+                                       Bucket<K,D,B> >::type;
+
+        template <class K, class D, size_t B, class Hashed>
+        using bucket_type     = typename std::conditional<BS == 0,
+                                    cache_aligned<packed_bucket_type<K,D,B,Hashed> >,
+                                    packed_bucket_type<K,D,B,Hashed> >::type;
+
+        // slots per bucket, with BS == 0 one bucket fills one or two
+        // cache lines (depending on the size of K, D, and Hashed)
+        template <class K, class D, class Hashed>
+        static constexpr size_t slots()
+        { return (BS) ? BS : cache_line_slots<cuckoo_config, K, D, Hashed>::value; }
     };
 
 
@@ -105,19 +185,28 @@ namespace dysect
         using  specialized_type = typename cuckoo_traits<SCuckoo>::specialized_type;
         using  dis_strat_type   = typename cuckoo_traits<SCuckoo>::config_type::template dis_strat_type<this_type>;
         using  hist_count_type  = typename cuckoo_traits<SCuckoo>::config_type::hist_count_type;
+        using  latency_count_type = typename cuckoo_traits<SCuckoo>::config_type::latency_count_type;
+        using  latency_scope    = typename latency_count_type::scope;
         using  bucket_type      = typename cuckoo_traits<SCuckoo>::bucket_type;
         using  hasher_type      = typename cuckoo_traits<SCuckoo>::hasher_type;
-        using  hashed_type      = typename hasher_type::hashed_type;
+
+        template<class LKey>
+        using  transparent_lookup = typename std::enable_if<
+                                        hasher_type::template transparent<LKey>::value>::type;
 
         friend specialized_type;
         friend dis_strat_type;
+        // strategies used within dis_adaptive
+        template<class> friend class cuckoo_displacement::dis_bfs1;
+        template<class> friend class ::dis_random_walk_optimistic;
+        template<class> friend class stash_incr;
 
     public:
         using key_type        = typename cuckoo_traits<SCuckoo>::key_type;
         using mapped_type     = typename cuckoo_traits<SCuckoo>::mapped_type;
-        using value_type      = std::pair<const key_type, mapped_type>;
-        using iterator        = iterator_base<iterator_incr<specialized_type> >;
-        using const_iterator  = iterator_base<iterator_incr<specialized_type>, true>;
+        using value_type      = typename element_traits<key_type, mapped_type>::value_type;
+        using iterator        = iterator_base<stash_incr<iterator_incr<specialized_type> > >;
+        using const_iterator  = iterator_base<stash_incr<iterator_incr<specialized_type> >, true>;
         using size_type       = size_t;
         using difference_type = std::ptrdiff_t;
         // using hasher          = Hash;
@@ -128,12 +217,16 @@ namespace dysect
         // using pointer         = std::allocator_traits<Allocator>::pointer;
         // using const_pointer   = std::allocator_traits<Allocator>::const_pointer;
         using insert_return_type   = std::pair<iterator, bool>;
+        using hashed_type          = typename hasher_type::hashed_type;
 
         using local_iterator       = void;
         using const_local_iterator = void;
         using node_type            = void;
     private:
-        using  value_intern    = std::pair<key_type, mapped_type>;
+        using  value_intern           = typename element_traits<key_type, mapped_type>::value_intern;
+        using  mapped_param_type      = typename element_traits<key_type, mapped_type>::mapped_param_type;
+        using  mapped_reference       = typename element_traits<key_type, mapped_type>::mapped_reference;
+        using  const_mapped_reference = typename element_traits<key_type, mapped_type>::const_mapped_reference;
 
     public:
         cuckoo_base(double size_constraint = 1.1,
@@ -146,6 +239,9 @@ namespace dysect
             {
                 n = rhs.n; capacity = rhs.capacity;
                 grow_thresh = rhs.grow_thresh; alpha = rhs.alpha;
+                hash_seed = rhs.hash_seed; hasher = rhs.hasher;
+                rehash_thresh = rhs.rehash_thresh;
+                stash = std::move(rhs.stash); stash_max = rhs.stash_max;
                 return *this;
             }
 
@@ -155,34 +251,107 @@ namespace dysect
         size_type       capacity;
         size_type       grow_thresh;
         double          alpha;
+        size_type       hash_seed;
         hasher_type     hasher;
         dis_strat_type  displacer;
         hist_count_type hcounter;
+        mutable latency_count_type lcounter;
+        size_type       rehash_thresh;
+        std::vector<value_intern> stash;
+        size_type       stash_max;
+        static constexpr size_type rehash_tries = 3;
+        static constexpr size_type batch_group  = 16;
         static constexpr size_type bs = cuckoo_traits<specialized_type>::bs;
         static constexpr size_type tl = cuckoo_traits<specialized_type>::tl;
         static constexpr size_type nh = cuckoo_traits<specialized_type>::nh;
+        static constexpr bool primary_first =
+            cuckoo_traits<SCuckoo>::config_type::primary_first;
 
     public:
     // Basic Hash Table Functionality ******************************************
         iterator              find  (const key_type& k);
         const_iterator        find  (const key_type& k) const;
-        insert_return_type    insert(const key_type& k, const mapped_type& d);
+        insert_return_type    insert(const key_type& k, const mapped_param_type& d);
         insert_return_type    insert(const value_intern& t);
+        insert_return_type    insert(value_intern&& t);
         size_type             erase (const key_type& k);
 
+        // constructs the element from args (pair arguments, or the key
+        // for sets), the element is moved into the table (and through
+        // displacements)
+        template<class... Args>
+        insert_return_type    emplace(Args&&... args);
+        // only for maps: the value is only constructed if k is new,
+        // insert_or_assign overwrites the value of an existing key
+        template<class... Args>
+        insert_return_type    try_emplace(const key_type& k, Args&&... args);
+        template<class M>
+        insert_return_type    insert_or_assign(const key_type& k, M&& obj);
+        // only for maps: inserts (k, init) if k is new, otherwise fn is
+        // applied to the stored value (fn(mapped_type&)), both in one
+        // pass over the buckets of k.  fetch_add(k, d) adds d to the
+        // value of k (inserts (k, d) if k is new)
+        template<class F>
+        insert_return_type    upsert(const key_type& k, const mapped_param_type& init, F fn);
+        insert_return_type    fetch_add(const key_type& k, const mapped_param_type& d);
+
+        // writes find(keys[i]) for i < n_keys to the output iterator out
+        // (e.g. std::back_inserter(vec)), the buckets of each group of
+        // keys are prefetched before they are probed
+        template<class OutputIt>
+        OutputIt              find_batch(const key_type* keys, size_type n_keys,
+                                         OutputIt out);
+        template<class OutputIt>
+        OutputIt              find_batch(const key_type* keys, size_type n_keys,
+                                         OutputIt out) const;
+        // inserts all elements of [first, last) (pairs, or keys for sets),
+        // returns the number of inserted (new) elements, elements that need
+        // displacements are inserted in a second pass
+        template<class InputIt>
+        size_type             insert_batch(InputIt first, InputIt last);
+
     // Easy use Accessors for std compliance ***********************************
         inline iterator       begin ();       // see specialized_type
-        inline const_iterator begin () const { return static_cast<specialized_type*>(this)->cbegin(); }
+        inline const_iterator begin () const { return static_cast<const specialized_type*>(this)->cbegin(); }
         inline const_iterator cbegin() const; // see specialized_type
         inline iterator       end   ()       { return make_iterator(nullptr); }
-        inline const_iterator end   () const { return static_cast<specialized_type*>(this)->cend(); }
+        inline const_iterator end   () const { return static_cast<const specialized_type*>(this)->cend(); }
         inline const_iterator cend  () const { return make_citerator(nullptr); }
 
-        mapped_type&          at    (const key_type& k);
-        const mapped_type&    at    (const key_type& k) const;
-        mapped_type&          operator[](const key_type& k);
+        // only for maps (mapped_type not void)
+        mapped_reference       at    (const key_type& k);
+        const_mapped_reference at    (const key_type& k) const;
+        mapped_reference       operator[](const key_type& k);
         size_type             count (const key_type& k) const;
 
+    // Hash once (h has to be hash(k)) *****************************************
+        // hashed values stay valid while the table grows, not across a
+        // rehash, tables with the same seed compute the same values
+        hashed_type           hash  (const key_type& k) const { return hasher(k); }
+        iterator              find_hashed  (const key_type& k, hashed_type h);
+        const_iterator        find_hashed  (const key_type& k, hashed_type h) const;
+        insert_return_type    insert_hashed(const key_type& k, const mapped_param_type& d,
+                                            hashed_type h);
+        insert_return_type    insert_hashed(value_intern&& t, hashed_type h);
+        size_type             erase_hashed (const key_type& k, hashed_type h);
+        // prefetches all buckets of h (e.g. a few operations ahead)
+        void                  prefetch     (hashed_type h) const;
+
+    // Heterogeneous lookup (only with a transparent hash function) ************
+        // e.g. std::string_view for std::string keys, compared with operator==
+        template<class LKey, class = transparent_lookup<LKey> >
+        iterator              find  (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        const_iterator        find  (const LKey& k) const;
+        template<class LKey, class = transparent_lookup<LKey> >
+        size_type             erase (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        mapped_reference       at    (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        const_mapped_reference at    (const LKey& k) const;
+        template<class LKey, class = transparent_lookup<LKey> >
+        size_type             count (const LKey& k) const;
+
     // Global fill state *******************************************************
         inline size_type      empty()    const { return (n == 0); }
         inline size_type      size()     const { return n; }
@@ -191,6 +360,17 @@ namespace dysect
         inline void           clear()
             { auto temp = specialized_type(0, alpha); (*this) = temp; }
 
+    // Stash *******************************************************************
+        // at most s elements are stashed (0 = no stash, default) instead of
+        // rehashing or growing within an insert, this bounds its latency
+        void                  set_stash_size(size_type s)
+            { stash_max = s; stash.reserve(s); }
+        inline size_type      stash_size() const { return stash.size(); }
+        // tries to move up to max_steps stashed elements into their
+        // buckets (with displacements), returns the number of moved elements
+        size_type             maintenance(size_type max_steps
+                                          = std::numeric_limits<size_type>::max());
+
 
     private:
     // Easy iterators **********************************************************
@@ -200,15 +380,111 @@ namespace dysect
         inline const_iterator make_citerator(const value_intern* pos) const
             { return const_iterator(pos, *static_cast<const specialized_type*>(this)); }
 
+        // iterators to the first stashed element (end if there is none),
+        // begin of the specialized table returns them if the buckets are empty
+        inline iterator       stash_begin ()
+            { return make_iterator (stash.empty() ? nullptr : stash.data()); }
+        inline const_iterator stash_cbegin() const
+            { return make_citerator(stash.empty() ? nullptr : stash.data()); }
+
     // implementation specific functions (static polymorph) ********************
         inline void           inc_n() { ++n; }
         inline void           dec_n() { --n; }
+        // grows the specialized table (timed as table_op::grow)
+        inline void           grow_table()
+            {
+                latency_scope lat(lcounter, table_op::grow);
+                static_cast<specialized_type*>(this)->grow();
+                // growing frees slots (no displacements, stashed elements
+                // are only moved if one of their buckets has space)
+                for (size_type i = stash.size(); i > 0; ) unstash(--i, false);
+            }
         inline void           get_buckets(hashed_type h, bucket_type** mem) const
             { return static_cast<const specialized_type*>(this)->get_buckets(h, mem); }
         inline bucket_type*   get_bucket (hashed_type h, size_type i) const
             { return static_cast<const specialized_type*>(this)->get_bucket(h, i); }
 
+        // subtable fill counters (no counters by default), only kept if the
+        // displacer uses them (uses_fill, e.g. dis_random_walk_load)
+        inline void           fill_changed(hashed_type, const bucket_type*, int) { }
+        inline void           fill_reset  () { }
+        inline double         fill_ratio  (hashed_type, size_type) const { return 0.; }
+        // b (one of the buckets of h) gained (d = 1) or lost (d = -1) an element
+        inline void           count_fill (hashed_type h, const bucket_type* b, int d)
+            {
+                if (uses_fill<dis_strat_type>::value)
+                    static_cast<specialized_type*>(this)->fill_changed(h, b, d);
+            }
+        inline double         subtable_load(hashed_type h, size_type i) const
+            { return static_cast<const specialized_type*>(this)->fill_ratio(h, i); }
+
+        // hash of a stored element (without rehashing if the bucket stores it)
+        inline hashed_type    slot_hash(const bucket_type* b, size_type i) const
+            { return dysect::slot_hash<bucket_type>::get(*b, i, hasher); }
+        // hashes of the first n elements of b (hashed at once)
+        inline void           slot_hashes(const bucket_type* b, size_type n,
+                                          hashed_type* out) const
+            { dysect::slot_hash<bucket_type>::get_n(*b, n, hasher, out); }
+
+        // lookup of up to batch_group keys (see find_batch), out[i] is
+        // nullptr for missing keys
+        void                  find_group(const key_type* keys, size_type n_keys,
+                                         value_intern** out) const;
+
+        // lookup and removal for key_type and heterogeneous keys
+        // (erase_key see specialized_type)
+        template<class LKey>
+        value_intern*         find_ptr (const LKey& k, hashed_type hash) const;
+        template<class LKey>
+        size_type             erase_key(const LKey& k, hashed_type hash);
+        // position of k in the stash (nullptr if it is not stashed)
+        template<class LKey>
+        value_intern*         find_stash(const LKey& k) const;
+        // the element with key key_type() is stashed if the buckets mark
+        // empty slots with it (bucket, co_bucket), like the separate slot
+        // of key 0 in prob_base, it does not count towards stash_max
+        template<class LKey>
+        static bool           is_empty_key(const LKey& k)
+            { return bucket_type::empty_key && key_type() == k; }
+        // stashes t (its key is empty and not yet stashed)
+        insert_return_type    insert_empty_key(value_intern&& t);
+        // moves stash[i] into one of its buckets (displacing elements if
+        // necessary and displace), called once per insert (without
+        // displacements), after growing, and by maintenance()
+        bool                  unstash(size_type i, bool displace);
+
+        // probes all buckets of k, returns the position of k (first) or
+        // the bucket with the most free slots (second, nullptr if all
+        // buckets are full), with primary_first the first bucket with space
+        std::pair<value_intern*, bucket_type*> probe(const key_type& k, hashed_type hash);
+        // inserts t (not contained) using the displacer (or the stash, or
+        // rehashing)
+        insert_return_type    insert_displace(value_intern& t, hashed_type hash);
+        // one pass over the buckets of k (hash == hash(k)), returns the
+        // position of k if it is contained, otherwise the element make()
+        // is inserted (make is only called for new keys), used by
+        // insert_hashed, try_emplace, insert_or_assign and upsert
+        template<class Make>
+        insert_return_type    insert_with(const key_type& k, hashed_type hash, Make make);
+
+    // Rehashing (new hash functions, same memory) *****************************
+        // each table draws its own hash functions (random if seed == 0)
+        static size_type      random_seed()
+            { std::random_device rd; return (size_type(rd()) << 32) ^ rd(); }
+        bool                  place  (value_intern& e, hashed_type hash);
+        void                  restamp(bucket_type* b);
+        // new hash functions in the same memory (see getTable), at least
+        // capacity/4 insertions apart, otherwise the table grows
+        bool                  rehash (const value_intern& t); // see specialized_type
+
+        // adds subtables, bucket fill, and bucket memory (using getTable),
+        // specialized tables can replace or extend it
+        void                  add_stats(table_stats& s) const;
+
     public:
+    // Memory and fill state (see table_stats.h) *******************************
+        table_stats           stats() const;
+
     // auxiliary functions for testing *****************************************
         void                  clearHist();
         void                  print_init_data(std::ostream& out);
@@ -223,8 +499,13 @@ namespace dysect
 
         void explicit_grow()
         {
-                static_cast<specialized_type*>(this)->grow();
+                grow_table();
         }
+
+        const latency_count_type& latency() const { return lcounter; }
+
+        // e.g. to change the thresholds of dis_adaptive at runtime
+        dis_strat_type&       displacement() { return displacer; }
     };
 
 
@@ -236,14 +517,19 @@ namespace dysect
                                               size_type dis_steps, size_type seed)
         : n(0), capacity(0), grow_thresh(std::numeric_limits<size_type>::max()),
           alpha(size_constraint),
+          hash_seed((seed) ? seed : random_seed()), hasher(hash_seed),
           displacer(*this, dis_steps, seed),
-          hcounter(dis_steps)
+          hcounter(dis_steps), rehash_thresh(0), stash_max(0)
     { }
 
     template<class SCuckoo>
     cuckoo_base<SCuckoo>::cuckoo_base(cuckoo_base&& rhs)
         : n(rhs.n), capacity(rhs.capacity), alpha(rhs.alpha),
-          displacer(*this, std::move(rhs.displacer))
+          hash_seed(rhs.hash_seed), hasher(rhs.hasher),
+          displacer(*this, std::move(rhs.displacer)),
+          lcounter(std::move(rhs.lcounter)),
+          rehash_thresh(rhs.rehash_thresh),
+          stash(std::move(rhs.stash)), stash_max(rhs.stash_max)
     { }
 
 
@@ -254,64 +540,107 @@ namespace dysect
     inline typename cuckoo_base<SCuckoo>::iterator
     cuckoo_base<SCuckoo>::find(const key_type& k)
     {
-        auto hash = hasher(k);
-
-        for (size_type i = 0; i < nh; ++i)
-        {
-            bucket_type* tb = get_bucket(hash, i);
-            value_intern*   tp = tb->find_ptr(k);
-            if (tp) return make_iterator(tp);
-        }
-        return end();
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, hasher(k));
+        return (tp) ? make_iterator(tp) : end();
     }
 
     template<class SCuckoo>
     inline typename cuckoo_base<SCuckoo>::const_iterator
     cuckoo_base<SCuckoo>::find(const key_type& k) const
     {
-        auto hash = hasher(k);
-
-        for (size_type i = 0; i < nh; ++i)
-        {
-            bucket_type* tb = get_bucket(hash, i);
-            value_intern*   tp = tb->find_ptr(k);
-            if (tp) return make_citerator(tp);
-        }
-        return end();
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, hasher(k));
+        return (tp) ? make_citerator(tp) : end();
     }
 
     template<class SCuckoo>
     inline typename cuckoo_base<SCuckoo>::insert_return_type
-    cuckoo_base<SCuckoo>::insert(const key_type& k, const mapped_type& d)
+    cuckoo_base<SCuckoo>::insert(const key_type& k, const mapped_param_type& d)
     {
-        return insert(std::make_pair(k,d));
+        return insert(element_traits<key_type, mapped_type>::make(k,d));
     }
 
     template<class SCuckoo>
     inline typename cuckoo_base<SCuckoo>::insert_return_type
     cuckoo_base<SCuckoo>::insert(const value_intern& t)
     {
-        if (n > grow_thresh) static_cast<specialized_type*>(this)->grow();
-        auto hash = hasher(t.first);
+        return insert(value_intern(t));
+    }
 
-        std::pair<int,value_intern*> max = std::make_pair(0, nullptr);
-        for (size_type i = 0; i < nh; ++i)
-        {
-            auto temp = get_bucket(hash, i)->probe_ptr(t.first);
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert(value_intern&& t)
+    {
+        return insert_hashed(std::move(t), hasher(t.first));
+    }
 
-            if (temp.first < 0)
-                return std::make_pair(make_iterator(temp.second), false);
-            max = (max.first > temp.first) ? max : temp;
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_hashed(value_intern&& t, hashed_type hash)
+    {
+        return static_cast<specialized_type*>(this)->insert_with(
+            t.first, hash, [&t]() -> value_intern&& { return std::move(t); });
+    }
+
+    template<class SCuckoo> template<class Make>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_with(const key_type& k, hashed_type hash, Make make)
+    {
+        latency_scope lat(lcounter, table_op::insert);
+        if (is_empty_key(k))
+        {
+            value_intern* sp = find_stash(k);
+            if (sp) return std::make_pair(make_iterator(sp), false);
+            return insert_empty_key(make());
         }
+        // growing does not change the hash functions
+        if (n > grow_thresh) grow_table();
+        if (! stash.empty()) unstash(n % stash.size(), false);
 
-        if (max.first > 0)
+        auto pr = probe(k, hash);
+        value_intern* pos = (pr.first || stash.empty()) ? pr.first : find_stash(k);
+        if (pos) return std::make_pair(make_iterator(pos), false);
+
+        // k may be a member of the made element, it is not used below
+        if (pr.second)
         {
-            *max.second = t;
+            pos = pr.second->insert_ptr(make(), hash);
+            count_fill(hash, pr.second, 1);
             hcounter.add(0);
             static_cast<specialized_type*>(this)->inc_n();
-            return std::make_pair(make_iterator(max.second), true);
+            return std::make_pair(make_iterator(pos), true);
         }
 
+        value_intern t = make();
+        return insert_displace(t, hash);
+    }
+
+    template<class SCuckoo>
+    inline std::pair<typename cuckoo_base<SCuckoo>::value_intern*,
+                     typename cuckoo_base<SCuckoo>::bucket_type*>
+    cuckoo_base<SCuckoo>::probe(const key_type& k, hashed_type hash)
+    {
+        int          max_space  = 0;
+        bucket_type* max_bucket = nullptr;
+        for (size_type i = 0; i < nh; ++i)
+        {
+            bucket_type* tb   = get_bucket(hash, i);
+            auto         temp = tb->probe_ptr(k, hash);
+
+            if (temp.first < 0)
+                return std::make_pair(temp.second, nullptr);
+            if (primary_first ? (temp.first > 0 && ! max_space)
+                              : (temp.first >= max_space))
+            { max_space = temp.first; max_bucket = tb; }
+        }
+        return std::make_pair(nullptr, (max_space > 0) ? max_bucket : nullptr);
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_displace(value_intern& t, hashed_type hash)
+    {
         int  srch = -1;
         value_intern* pos  = nullptr;
         std::tie(srch, pos) = displacer.insert(t, hash);
@@ -322,19 +651,117 @@ namespace dysect
             return std::make_pair(make_iterator(pos), true);
         }
 
+        // t is unchanged, if the displacement failed. It is stashed (no
+        // reallocation, the capacity is reserved), or the table is rehashed
+        size_type stashed = stash.size();
+        if (stashed && bucket_type::empty_key && find_stash(key_type())) --stashed;
+        if (stashed < stash_max)
+        {
+            stash.push_back(std::move(t));
+            static_cast<specialized_type*>(this)->inc_n();
+            return std::make_pair(make_iterator(&stash.back()), true);
+        }
+
+        // Rehashing moves
+        // elements, therefore t has to be found again
+        if (static_cast<specialized_type*>(this)->rehash(t))
+        {
+            auto it = find(t.first);
+            return std::make_pair(it, it != end());
+        }
+
         return std::make_pair(end(), false);
     }
 
+    template<class SCuckoo> template<class... Args>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::emplace(Args&&... args)
+    {
+        return static_cast<specialized_type*>(this)->insert(
+            value_intern(std::forward<Args>(args)...));
+    }
+
+    template<class SCuckoo> template<class... Args>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::try_emplace(const key_type& k, Args&&... args)
+    {
+        return static_cast<specialized_type*>(this)->insert_with(k, hasher(k), [&]()
+            { return value_intern(std::piecewise_construct, std::forward_as_tuple(k),
+                                  std::forward_as_tuple(std::forward<Args>(args)...)); });
+    }
+
+    template<class SCuckoo> template<class M>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_or_assign(const key_type& k, M&& obj)
+    {
+        // obj is either moved into the new element or assigned
+        auto result = static_cast<specialized_type*>(this)->insert_with(k, hasher(k), [&]()
+            { return value_intern(k, std::forward<M>(obj)); });
+        if (! result.second && result.first != end())
+            (*result.first).second = std::forward<M>(obj);
+        return result;
+    }
+
+    template<class SCuckoo> template<class F>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::upsert(const key_type& k, const mapped_param_type& init, F fn)
+    {
+        auto result = static_cast<specialized_type*>(this)->insert_with(k, hasher(k), [&]()
+            { return value_intern(k, init); });
+        if (! result.second && result.first != end()) fn((*result.first).second);
+        return result;
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::fetch_add(const key_type& k, const mapped_param_type& d)
+    {
+        return static_cast<specialized_type*>(this)->upsert(k, d,
+                                                            [&d](mapped_type& v) { v += d; });
+    }
+
     template<class SCuckoo>
     inline typename cuckoo_base<SCuckoo>::size_type
     cuckoo_base<SCuckoo>::erase(const key_type& k)
     {
-        auto hash = hasher(k);
+        latency_scope lat(lcounter, table_op::erase);
+        return static_cast<specialized_type*>(this)->erase_key(k, hasher(k));
+    }
+
+    template<class SCuckoo> template<class LKey>
+    inline typename cuckoo_base<SCuckoo>::value_intern*
+    cuckoo_base<SCuckoo>::find_ptr(const LKey& k, hashed_type hash) const
+    {
+        if (is_empty_key(k)) return find_stash(k);
         for (size_type i = 0; i < nh; ++i)
         {
             bucket_type* tb = get_bucket(hash, i);
-            if (tb->remove(k))
+            value_intern*   tp = tb->find_ptr(k, hash);
+            if (tp) return tp;
+        }
+        return (stash.empty()) ? nullptr : find_stash(k);
+    }
+
+    template<class SCuckoo> template<class LKey>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::erase_key(const LKey& k, hashed_type hash)
+    {
+        for (size_type i = 0; i < nh && ! is_empty_key(k); ++i)
+        {
+            bucket_type* tb = get_bucket(hash, i);
+            if (tb->remove(k, hash))
             {
+                count_fill(hash, tb, -1);
+                static_cast<specialized_type*>(this)->dec_n();
+                return 1;
+            }
+        }
+        for (size_type i = 0; i < stash.size(); ++i)
+        {
+            if (stash[i].first == k)
+            {
+                if (i+1 < stash.size()) stash[i] = std::move(stash.back());
+                stash.pop_back();
                 static_cast<specialized_type*>(this)->dec_n();
                 return 1;
             }
@@ -342,12 +769,413 @@ namespace dysect
         return 0;
     }
 
+    template<class SCuckoo> template<class LKey>
+    inline typename cuckoo_base<SCuckoo>::value_intern*
+    cuckoo_base<SCuckoo>::find_stash(const LKey& k) const
+    {
+        for (auto& e : stash)
+        {
+            if (e.first == k) return const_cast<value_intern*>(&e);
+        }
+        return nullptr;
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_empty_key(value_intern&& t)
+    {
+        stash.push_back(std::move(t));
+        static_cast<specialized_type*>(this)->inc_n();
+        return std::make_pair(make_iterator(&stash.back()), true);
+    }
+
+
+
+// Hash once *******************************************************************
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::iterator
+    cuckoo_base<SCuckoo>::find_hashed(const key_type& k, hashed_type h)
+    {
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, h);
+        return (tp) ? make_iterator(tp) : end();
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::const_iterator
+    cuckoo_base<SCuckoo>::find_hashed(const key_type& k, hashed_type h) const
+    {
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, h);
+        return (tp) ? make_citerator(tp) : end();
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::insert_return_type
+    cuckoo_base<SCuckoo>::insert_hashed(const key_type& k, const mapped_param_type& d,
+                                        hashed_type h)
+    {
+        return static_cast<specialized_type*>(this)->insert_hashed(
+            element_traits<key_type, mapped_type>::make(k,d), h);
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::erase_hashed(const key_type& k, hashed_type h)
+    {
+        latency_scope lat(lcounter, table_op::erase);
+        return static_cast<specialized_type*>(this)->erase_key(k, h);
+    }
+
+    template<class SCuckoo>
+    inline void cuckoo_base<SCuckoo>::prefetch(hashed_type h) const
+    {
+        bucket_type* buckets[nh];
+        get_buckets(h, buckets);
+        for (size_type i = 0; i < nh; ++i) prefetch_lines(buckets[i]);
+    }
+
+
+
+// Heterogeneous lookup ********************************************************
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::iterator
+    cuckoo_base<SCuckoo>::find(const LKey& k)
+    {
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, hasher(k));
+        return (tp) ? make_iterator(tp) : end();
+    }
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::const_iterator
+    cuckoo_base<SCuckoo>::find(const LKey& k) const
+    {
+        latency_scope lat(lcounter, table_op::find);
+        value_intern* tp = find_ptr(k, hasher(k));
+        return (tp) ? make_citerator(tp) : end();
+    }
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::erase(const LKey& k)
+    {
+        latency_scope lat(lcounter, table_op::erase);
+        return static_cast<specialized_type*>(this)->erase_key(k, hasher(k));
+    }
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::mapped_reference
+    cuckoo_base<SCuckoo>::at(const LKey& k)
+    {
+        auto a = static_cast<specialized_type*>(this)->find(k);
+        if (a == end()) throw std::out_of_range("cannot find key");
+        else return (*a).second;
+    }
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::const_mapped_reference
+    cuckoo_base<SCuckoo>::at(const LKey& k) const
+    {
+        auto a = static_cast<const specialized_type*>(this)->find(k);
+        if (a == cend()) throw std::out_of_range("cannot find key");
+        else return (*a).second;
+    }
+
+    template<class SCuckoo> template<class LKey, class>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::count(const LKey& k) const
+    {
+        return (static_cast<const specialized_type*>(this)->find(k) != cend()) ? 1 : 0;
+    }
+
+
+
+// Batched lookups *************************************************************
+
+    template<class SCuckoo>
+    inline void
+    cuckoo_base<SCuckoo>::find_group(const key_type* keys, size_type n_keys,
+                                     value_intern** out) const
+    {
+        hashed_type  hashes [batch_group];
+        bucket_type* buckets[batch_group][nh];
+
+        // hash the group and prefetch all of its buckets
+        hasher.hash_n(keys, n_keys, hashes);
+        for (size_type i = 0; i < n_keys; ++i)
+        {
+            get_buckets(hashes[i], buckets[i]);
+            for (size_type j = 0; j < nh; ++j) prefetch_lines(buckets[i][j]);
+        }
+
+        // probe the (hopefully cached) buckets
+        for (size_type i = 0; i < n_keys; ++i)
+        {
+            value_intern* ptr = nullptr;
+            for (size_type j = 0; j < nh && !ptr && ! is_empty_key(keys[i]); ++j)
+                ptr = buckets[i][j]->find_ptr(keys[i], hashes[i]);
+            out[i] = (ptr || stash.empty()) ? ptr : find_stash(keys[i]);
+        }
+    }
+
+    template<class SCuckoo> template<class OutputIt>
+    inline OutputIt
+    cuckoo_base<SCuckoo>::find_batch(const key_type* keys, size_type n_keys,
+                                     OutputIt out)
+    {
+        value_intern* ptrs[batch_group];
+        for (size_type g = 0; g < n_keys; g += batch_group)
+        {
+            size_type gsize = std::min(batch_group, n_keys - g);
+            find_group(keys + g, gsize, ptrs);
+            for (size_type i = 0; i < gsize; ++i, ++out)
+                *out = (ptrs[i]) ? make_iterator(ptrs[i]) : end();
+        }
+        return out;
+    }
+
+    template<class SCuckoo> template<class OutputIt>
+    inline OutputIt
+    cuckoo_base<SCuckoo>::find_batch(const key_type* keys, size_type n_keys,
+                                     OutputIt out) const
+    {
+        value_intern* ptrs[batch_group];
+        for (size_type g = 0; g < n_keys; g += batch_group)
+        {
+            size_type gsize = std::min(batch_group, n_keys - g);
+            find_group(keys + g, gsize, ptrs);
+            for (size_type i = 0; i < gsize; ++i, ++out)
+                *out = (ptrs[i]) ? make_citerator(ptrs[i]) : cend();
+        }
+        return out;
+    }
+
+
+
+    template<class SCuckoo> template<class InputIt>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::insert_batch(InputIt first, InputIt last)
+    {
+        size_type    inserted = 0;
+        value_intern elems  [batch_group];
+        key_type     keys   [batch_group];
+        hashed_type  hashes [batch_group];
+        bucket_type* buckets[batch_group][nh];
+        std::vector<value_intern> deferred;
+
+        while (first != last)
+        {
+            // growing moves buckets, therefore, only between groups
+            if (n > grow_thresh) grow_table();
+
+            size_type gsize = 0;
+            for ( ; gsize < batch_group && first != last; ++gsize, ++first)
+            {
+                elems[gsize] = value_intern(*first);
+                keys [gsize] = elems[gsize].first;
+            }
+
+            hasher.hash_n(keys, gsize, hashes);
+            for (size_type i = 0; i < gsize; ++i)
+            {
+                get_buckets(hashes[i], buckets[i]);
+                for (size_type j = 0; j < nh; ++j) prefetch_lines(buckets[i][j]);
+            }
+
+            // same as insert, without displacements
+            for (size_type i = 0; i < gsize; ++i)
+            {
+                if (is_empty_key(keys[i]))
+                {
+                    deferred.push_back(std::move(elems[i]));
+                    continue;
+                }
+                auto pr = probe(keys[i], hashes[i]);
+                if (pr.first || (! stash.empty() && find_stash(keys[i]))) continue;
+
+                if (pr.second)
+                {
+                    pr.second->insert_ptr(std::move(elems[i]), hashes[i]);
+                    count_fill(hashes[i], pr.second, 1);
+                    hcounter.add(0);
+                    static_cast<specialized_type*>(this)->inc_n();
+                    ++inserted;
+                }
+                else deferred.push_back(std::move(elems[i]));
+            }
+        }
+
+        // displacements (insert checks again for duplicates)
+        for (auto& e : deferred)
+        {
+            if (static_cast<specialized_type*>(this)->insert(std::move(e)).second) ++inserted;
+        }
+        return inserted;
+    }
+
+
+
+// Rehashing *******************************************************************
+
+    // inserts e into one of its buckets (displacing elements if
+    // necessary), e is moved from, unless placing fails, the bucket is
+    // chosen like in probe (e is not in the table)
+    template<class SCuckoo>
+    inline bool cuckoo_base<SCuckoo>::place(value_intern& e, hashed_type hash)
+    {
+        int          max_space  = 0;
+        bucket_type* max_bucket = nullptr;
+        for (size_type i = 0; i < nh; ++i)
+        {
+            bucket_type* tb = get_bucket(hash, i);
+            int space = bs - tb->size();
+            if (primary_first ? (space > 0 && ! max_space)
+                              : (space >= max_space))
+            { max_space = space; max_bucket = tb; }
+        }
+        if (! max_space) max_bucket = nullptr;
+        if (max_bucket) return max_bucket->insert_ptr(std::move(e), hash) != nullptr;
+
+        return displacer.insert(e, hash).first >= 0;
+    }
+
+    // recomputes the hash dependent information of all elements in b
+    // (tags and stored hashes), s.t. the bucket is consistent with hasher
+    template<class SCuckoo>
+    inline void cuckoo_base<SCuckoo>::restamp(bucket_type* b)
+    {
+        size_type    cnt = b->size();
+        key_type     keys  [bs];
+        value_intern elems [bs];
+        hashed_type  hashes[bs];
+        for (size_type j = 0; j < cnt; ++j)
+        {
+            elems[j] = std::move(b->elements[j]);
+            keys [j] = elems[j].first;
+        }
+        hasher.hash_n(keys, cnt, hashes);
+
+        *b = bucket_type();
+        for (size_type j = 0; j < cnt; ++j) b->insert_ptr(std::move(elems[j]), hashes[j]);
+    }
+
+    // rehashes the table into the same memory until t and all elements
+    // fit, retries with new hash functions up to rehash_tries times, then
+    // grows the table (no element is lost)
+    template<class SCuckoo>
+    inline bool cuckoo_base<SCuckoo>::rehash(const value_intern& t)
+    {
+        // another rehash would not be amortized yet, the table grows instead
+        if (n < rehash_thresh)
+        {
+            grow_table();
+            return insert(t).second;
+        }
+        rehash_thresh = n + (capacity >> 2);
+
+        std::vector<value_intern> pending(1, t);
+        for (size_type r = 0; r < rehash_tries && pending.size(); ++r)
+        {
+            hash_seed = hash_seed * 6364136223846793005ull + 1442695040888963407ull;
+            hasher.reseed(hash_seed);
+
+            for (size_type tab = 0; tab < tl; ++tab)
+            {
+                auto ltab = static_cast<specialized_type*>(this)->getTable(tab);
+                for (size_type i = 0; i < ltab.first; ++i) restamp(ltab.second + i);
+            }
+
+            // elements outside of their buckets are reinserted, elements
+            // that are moved by the displacer end up in one of their buckets
+            for (size_type tab = 0; tab < tl; ++tab)
+            {
+                auto ltab = static_cast<specialized_type*>(this)->getTable(tab);
+                for (size_type i = 0; i < ltab.first; ++i)
+                {
+                    bucket_type* b = ltab.second + i;
+                    for (size_type j = 0; j < b->size(); )
+                    {
+                        hashed_type  hash = slot_hash(b, j);
+                        bucket_type* targets[nh];
+                        get_buckets(hash, targets);
+
+                        bool fits = false;
+                        for (size_type ti = 0; ti < nh; ++ti)
+                            fits = fits || (targets[ti] == b);
+                        if (fits) { ++j; continue; }
+
+                        // remove refills slot j with the last element of b
+                        value_intern e = b->elements[j];
+                        b->remove(e.first, hash);
+                        if (! place(e, hash)) { --n; pending.push_back(std::move(e)); }
+                    }
+                }
+            }
+
+            std::vector<value_intern> failed;
+            for (auto& e : pending)
+            {
+                if (place(e, hasher(e.first))) ++n;
+                else                           failed.push_back(std::move(e));
+            }
+            std::swap(pending, failed);
+        }
+        if (uses_fill<dis_strat_type>::value)
+            static_cast<specialized_type*>(this)->fill_reset();
+
+        if (pending.empty()) return true;
+
+        // the table is too full, rehashing into the same memory is not enough
+        for (auto& e : pending)
+        {
+            while (! insert(e).second)
+                grow_table();
+        }
+        return true;
+    }
+
+
+
+// Stash ***********************************************************************
+
+    // the last stashed element takes the place of a moved element
+    template<class SCuckoo>
+    inline bool cuckoo_base<SCuckoo>::unstash(size_type i, bool displace)
+    {
+        value_intern& e    = stash[i];
+        if (is_empty_key(e.first)) return false;
+        hashed_type   hash = hasher(e.first);
+        bucket_type*  tb   = probe(e.first, hash).second;
+        if (tb) { tb->insert_ptr(std::move(e), hash); count_fill(hash, tb, 1); }
+        else if (! displace || displacer.insert(e, hash).first < 0) return false;
+
+        if (i+1 < stash.size()) stash[i] = std::move(stash.back());
+        stash.pop_back();
+        return true;
+    }
+
+    template<class SCuckoo>
+    inline typename cuckoo_base<SCuckoo>::size_type
+    cuckoo_base<SCuckoo>::maintenance(size_type max_steps)
+    {
+        size_type moved = 0;
+        size_type i     = stash.size();
+        for ( ; i > 0 && max_steps > 0; --max_steps)
+        {
+            if (unstash(--i, true)) ++moved;
+        }
+        return moved;
+    }
+
 
 
 // Accessor Implementations ****************************************************
 
     template<class SCuckoo>
-    inline typename cuckoo_base<SCuckoo>::mapped_type&
+    inline typename cuckoo_base<SCuckoo>::mapped_reference
     cuckoo_base<SCuckoo>::at(const key_type& k)
     {
         auto a = static_cast<specialized_type*>(this)->find(k);
@@ -356,7 +1184,7 @@ namespace dysect
     }
 
     template<class SCuckoo>
-    inline const typename cuckoo_base<SCuckoo>::mapped_type&
+    inline typename cuckoo_base<SCuckoo>::const_mapped_reference
     cuckoo_base<SCuckoo>::at(const key_type& k) const
     {
         auto a = static_cast<const specialized_type*>(this)->find(k);
@@ -365,10 +1193,10 @@ namespace dysect
     }
 
     template<class SCuckoo>
-    inline typename cuckoo_base<SCuckoo>::mapped_type&
+    inline typename cuckoo_base<SCuckoo>::mapped_reference
     cuckoo_base<SCuckoo>::operator[](const key_type& k)
     {
-        auto t = static_cast<specialized_type*>(this)->insert(k, mapped_type());
+        auto t = static_cast<specialized_type*>(this)->try_emplace(k);
         return (*t.first).second;
     }
 
@@ -381,6 +1209,46 @@ namespace dysect
 
 
 
+// Memory and fill state ******************************************************
+
+    template<class SCuckoo>
+    inline table_stats cuckoo_base<SCuckoo>::stats() const
+    {
+        table_stats s;
+        s.elements        = n;
+        s.capacity        = capacity;
+        s.element_bytes   = sizeof(value_intern);
+        s.bytes_allocated = sizeof(specialized_type)
+                            + stash.capacity() * sizeof(value_intern);
+        s.stashed         = stash.size();
+        static_cast<const specialized_type*>(this)->add_stats(s);
+        s.bytes_reserved  = std::max(s.bytes_reserved, s.bytes_allocated);
+        return s;
+    }
+
+    template<class SCuckoo>
+    inline void cuckoo_base<SCuckoo>::add_stats(table_stats& s) const
+    {
+        s.bucket_fill.assign(bs+1, 0);
+        for (size_type t = 0; ; ++t)
+        {
+            auto ltab = static_cast<const specialized_type*>(this)->getTable(t);
+            if (! ltab.second) break;
+
+            subtable_stats sub{size_type(ltab.first), ltab.first*bs, 0};
+            for (size_type i = 0; i < size_type(ltab.first); ++i)
+            {
+                size_type fill = ltab.second[i].size();
+                ++s.bucket_fill[fill];
+                sub.elements += fill;
+            }
+            s.subtables.push_back(sub);
+            s.bytes_allocated += ltab.first * sizeof(bucket_type);
+        }
+    }
+
+
+
 // Print Parameter Functions ***************************************************
 
 /*template<class SCuckoo>
@@ -407,6 +1275,49 @@ namespace dysect
     inline void cuckoo_base<SCuckoo>::clearHist()
     {
         for (size_type i = 0; i < hcounter.steps; ++i) hcounter.hist[i] = 0;
+        lcounter.clear();
     }
 
+
+
+// Iterator increment **********************************************************
+
+    // visits the elements of the buckets (Inner, see specialized_type),
+    // then the stashed elements
+    template<class Inner>
+    class stash_incr
+    {
+    public:
+        using table_type = typename Inner::table_type;
+    private:
+        using key_type     = typename table_type::key_type;
+        using mapped_type  = typename table_type::mapped_type;
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
+        using pointer      = typename element_traits<key_type, mapped_type>::value_type*;
+
+    public:
+        stash_incr(const table_type& table_)
+            : inner(table_), table(&table_)
+        { }
+        stash_incr(const stash_incr&) = default;
+        stash_incr& operator=(const stash_incr&) = default;
+
+        pointer next(pointer cur)
+        {
+            const auto& st = table->stash;
+            if (st.empty()) return inner.next(cur);
+
+            auto first = reinterpret_cast<pointer>(const_cast<value_intern*>(st.data()));
+            auto last  = first + st.size();
+            if (first <= cur && cur < last) return (cur+1 < last) ? cur+1 : nullptr;
+
+            auto ptr = inner.next(cur);
+            return (ptr) ? ptr : first;
+        }
+
+    private:
+        Inner             inner;
+        const table_type* table;
+    };
+
 } // namespace dysect
@@ -50,7 +50,7 @@ namespace dysect
         using const_iterator = typename base_type::const_iterator;
 
     private:
-        using value_intern = std::pair<key_type, mapped_type>;
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
 
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
@@ -66,8 +66,7 @@ namespace dysect
                           size_type dis_steps = 0, size_type seed = 0)
             : base_type(size_constraint, dis_steps, seed)
             {
-                auto temp = reinterpret_cast<value_intern*>(operator new (max_size));
-                table = std::unique_ptr<value_intern[]>(temp);
+                table = make_aligned_buffer<bucket_type>(max_size);
 
                 // SET CAPACITY, BITMASKS, THRESHOLD
                 size_type tcap = size_type(double(cap) * size_constraint / double(bs));
@@ -83,7 +82,7 @@ namespace dysect
                 bucket_cutoff = doub+bitmask_small+1;
                 grow_thresh   = size_type(double(capacity+grow_step*bs)/alpha);
 
-                std::fill(table.get(), table.get()+capacity, value_intern());
+                std::fill(table.get(), table.get()+bucket_cutoff, bucket_type());
             }
 
         cuckoo_deamortized(const cuckoo_deamortized&) = delete;
@@ -98,12 +97,13 @@ namespace dysect
         using base_type::grow_thresh;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::slot_hash;
 
         size_type bucket_cutoff;
         size_type bitmask_large;
         size_type bitmask_small;
 
-        std::unique_ptr<value_intern[]> table;
+        aligned_array<bucket_type> table;
 
         using base_type::make_iterator;
         using base_type::make_citerator;
@@ -111,7 +111,7 @@ namespace dysect
     public:
         using base_type::insert;
 
-        std::pair<size_type, bucket_type*> getTable(size_type i)
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
             {
                 return (! i) ? std::make_pair(bucket_cutoff, table.get())
                     : std::make_pair(0,nullptr);
@@ -119,34 +119,39 @@ namespace dysect
 
         inline iterator begin()
             {
-                auto temp = make_iterator(&table[0]);
-                if (! temp->first) temp++;
-                return temp;
+                auto ptr = first_in_buckets<value_intern*>(table.get(), bucket_cutoff);
+                return (ptr) ? make_iterator(ptr) : base_type::stash_begin();
             }
 
         inline const_iterator cbegin() const
             {
-                auto temp = make_citerator(&table[0]);
-                if (! temp->first) temp++;
-                return temp;
+                auto ptr = first_in_buckets<value_intern*>(table.get(), bucket_cutoff);
+                return (ptr) ? make_citerator(ptr) : base_type::stash_cbegin();
             }
 
     private:
+        // the table is overallocated (max_size bytes, see stats())
+        void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_reserved = sizeof(*this) + max_size;
+        }
+
         // Functions for finding buckets *******************************************
 
-        inline void getBuckets(hashed_type h, bucket_type** mem) const
+        inline void get_buckets(hashed_type h, bucket_type** mem) const
             {
                 for (size_type i = 0; i < nh; ++i)
                 {
-                    mem[i] = getBucket(h,i);
+                    mem[i] = get_bucket(h,i);
                 }
             }
 
-        inline bucket_type* getBucket(hashed_type h, size_type i) const
+        inline bucket_type* get_bucket(hashed_type h, size_type i) const
             {
                 size_type l = ext::loc(h,i) & bitmask_large;
                 if (l >= bucket_cutoff) l &= bitmask_small;
-                return reinterpret_cast<bucket_type*>(&(table[l*bs]));
+                return &(table[l]);
             }
 
 
@@ -159,7 +164,7 @@ namespace dysect
                 size_type ncutoff = bucket_cutoff + grow_step;
                 grow_thresh       = size_type(double(ncap+grow_step*bs)/alpha);
 
-                std::fill(table.get()+capacity, table.get()+ncap, value_intern());
+                std::fill(table.get()+bucket_cutoff, table.get()+ncutoff, bucket_type());
 
                 migrate(capacity, ncap);
 
@@ -177,42 +182,37 @@ namespace dysect
         inline void migrate(size_type , size_type)
             {
                 size_type flag  = bitmask_large  & (~bitmask_small);
-                size_type ptr0  = (bucket_cutoff & bitmask_small) * bs;
+                size_type ptr0  = bucket_cutoff & bitmask_small;
 
                 for (size_type i = 0; i < grow_step; ++i)
                 {
-                    bucket_type* bucket0_ptr =
-                        reinterpret_cast<bucket_type*>(table.get()+ptr0+i*bs);
-                    bucket_type* bucket1_ptr =
-                        reinterpret_cast<bucket_type*>(table.get()+capacity+i*bs);
-
-                    size_type c0 = 0;
-                    size_type c1 = 0;
-                    for (size_type j = 0; j < bs; ++j)
+                    bucket_type* bucket0_ptr = &(table[ptr0+i]);
+                    bucket_type* bucket1_ptr = &(table[bucket_cutoff+i]);
+
+                    for (size_type j = 0; j < bs && bucket0_ptr->occupied(j); )
                     {
-                        auto curr = bucket0_ptr->elements[j];
-                        bucket0_ptr->elements[j] = value_intern();
-                        if (!curr.first) break;
+                        bool move = false;
 
                         bucket_type* targets[nh];
-                        hashed_type  hash = hasher(curr.first);
-                        getBuckets(hash, targets);
+                        hashed_type  hash = slot_hash(bucket0_ptr, j);
+                        get_buckets(hash, targets);
 
                         for (size_type t = 0; t < nh; ++t)
                         {
                             if (targets[t] == bucket0_ptr)
                             {
-                                if (ext::loc(hash, t) & flag)
-                                {
-                                    bucket1_ptr->elements[c1++] = curr;
-                                }
-                                else
-                                {
-                                    bucket0_ptr->elements[c0++] = curr;
-                                }
+                                move = ext::loc(hash, t) & flag;
                                 break;
                             }
                         }
+
+                        // remove_at refills slot j with the last element of bucket0
+                        if (move)
+                        {
+                            bucket1_ptr->insert_ptr(std::move(bucket0_ptr->elements[j]), hash);
+                            bucket0_ptr->remove_at(j);
+                        }
+                        else ++j;
                     }
                 }
             }
@@ -236,11 +236,13 @@ namespace dysect
         using mapped_type      = D;
 
         static constexpr size_type tl = 1;
-        static constexpr size_type bs = Conf::bs;
         static constexpr size_type nh = Conf::nh;
 
         using hasher_type      = hasher<K, HF, 0, nh, true, true>;
-        using bucket_type      = bucket<K,D,bs>;
+        static constexpr size_type bs = Conf::template slots<K,D,
+                                        typename hasher_type::hashed_type>();
+        using bucket_type      = typename config_type::template bucket_type<K,D,bs,
+                                 typename hasher_type::hashed_type>;
 
     };
 
@@ -255,27 +257,22 @@ namespace dysect
         using table_type = cuckoo_deamortized<K,D,HF,Conf>;
     private:
         using size_type  = typename table_type::size_type;
-        using pointer    = std::pair<const K,D>*;
-        static constexpr size_type bs = Conf::bs;
+        using pointer    = typename element_traits<K,D>::value_type*;
 
     public:
         iterator_incr(const table_type& table_)
-            : end_ptr(reinterpret_cast<pointer>(&table_.table[table_.capacity -1]))
+            : table(&table_)
             { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
 
         pointer next(pointer cur)
             {
-                while (cur < end_ptr)
-                {
-                    if ((++cur)->first) return cur;
-                }
-                return nullptr;
+                return next_in_buckets(table->table.get(), table->bucket_cutoff, cur);
             }
 
     private:
-        pointer end_ptr;
+        const table_type* table;
     };
 
 } // namespace dysect
@@ -19,6 +19,15 @@
  * of memory).  This can be more efficient since offsets can be
  * computed more quickly.
  *
+ * Both variants can count the elements of each subtable (ll_elem,
+ * updated through fill_changed, only with load aware displacement, see
+ * cuckoo_base).  Right after a subtable grew, it is half empty,
+ * dis_random_walk_load uses these counters to move elements towards it.
+ *
+ * reserve(cap) grows all subtables to the layout the constructor would
+ * choose for cap (see dysect_layout), each subtable is migrated (at most)
+ * once, instead of once per doubling.
+ *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
  * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
@@ -35,6 +44,25 @@ namespace dysect
     template<class T>
     class cuckoo_traits;
 
+    // size of the small subtables and number of large subtables for a
+    // table that holds cap elements (tl subtables with buckets of bs slots)
+    template<size_t tl, size_t bs>
+    inline std::pair<size_t, size_t> dysect_layout(size_t cap, double alpha)
+    {
+        double avg_size_f = double(cap) * alpha / double(tl*bs);
+
+        size_t size_small = 1;
+        while(avg_size_f > (size_small << 1))
+            size_small <<= 1;
+
+        size_t nl = (size_small < avg_size_f)
+            ? std::floor(double(cap) * alpha / double(size_small * bs))-tl
+            : 0;
+        // all subtables large
+        if (nl >= tl) { size_small <<= 1; nl -= tl; }
+        return std::make_pair(size_small, nl);
+    }
+
     template<class K, class D, class HF = std::hash<K>,
              class Conf = cuckoo_config<> >
     class cuckoo_dysect : public cuckoo_traits<cuckoo_dysect<K,D,HF,Conf> >::base_type
@@ -62,24 +90,17 @@ namespace dysect
                       size_type dis_steps = 0, size_type seed = 0)
             : base_type(size_constraint, dis_steps, seed)
         {
-            double avg_size_f = double(cap) * size_constraint / double(tl*bs);
-
-            size_type size_small    = 1;
-            while(avg_size_f > (size_small << 1))
-                size_small <<= 1;
-
-            n_large = (size_small < avg_size_f)
-                ? std::floor(double(cap) * alpha / double(size_small * bs))-tl
-                : 0;
+            size_type size_small;
+            std::tie(size_small, n_large) = layout(cap);
 
             for (size_type i = 0; i < n_large; ++i)
             {
-                llt[i] = std::make_unique<bucket_type[]>(size_small << 1);
+                llt[i] = make_aligned_array<bucket_type>(size_small << 1);
             }
 
             for (size_type i = n_large; i < tl; ++i)
             {
-                llt[i] = std::make_unique<bucket_type[]>(size_small);
+                llt[i] = make_aligned_array<bucket_type>(size_small);
             }
 
             capacity    = (n_large+tl) * size_small * bs;
@@ -87,6 +108,7 @@ namespace dysect
             bits_large  = (size_small << 1) - 1;
             grow_thresh = std::ceil((capacity + (bits_large+1)*bs)/alpha);
             shrnk_thresh= 0; // ensures no shrinking until grown at least once
+            std::fill(ll_elem, ll_elem+tl, 0);
         }
 
         cuckoo_dysect(const cuckoo_dysect&) = delete;
@@ -102,7 +124,8 @@ namespace dysect
             for (size_type i = 0; i < tl; ++i)
             {
                 //llb[i] = rhs.llb[i];
-                llt[i] = std::move(rhs.llt[i]);
+                llt[i]     = std::move(rhs.llt[i]);
+                ll_elem[i] = rhs.ll_elem[i];
             }
         }
 
@@ -116,7 +139,8 @@ namespace dysect
 
             for (size_type i = 0; i < tl; ++i)
             {
-                std::swap(llt[i], rhs.llt[i]);
+                std::swap(llt[i],     rhs.llt[i]);
+                std::swap(ll_elem[i], rhs.ll_elem[i]);
             }
             return *this;
         }
@@ -127,6 +151,8 @@ namespace dysect
         using base_type::grow_thresh;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::slot_hash;
+        using base_type::slot_hashes;
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
         static constexpr size_type tl = cuckoo_traits<this_type>::tl;
@@ -137,26 +163,69 @@ namespace dysect
         size_type bits_large;
         size_type shrnk_thresh;
 
-        std::unique_ptr<bucket_type[]> llt[tl];
+        aligned_array<bucket_type> llt[tl];
+        size_type                  ll_elem[tl]; // elements per subtable
 
         static constexpr size_type tl_bitmask = tl - 1;
 
         using base_type::make_iterator;
         using base_type::make_citerator;
 
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
+
     public:
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
+        {
+            return (i < tl) ? std::make_pair(bitmask(i)+1, llt[i].get())
+                : std::make_pair(size_type(0), nullptr);
+        }
+
+        // grows the table to the layout of cuckoo_dysect(cap) (never shrinks
+        // it), like after construction, the table does not shrink below
+        // this size until it has grown again
+        void reserve(size_type cap)
+        {
+            size_type size_small, nl;
+            std::tie(size_small, nl) = layout(cap);
+            if (  size_small <  bits_small+1 ||
+                 (size_small == bits_small+1 && nl <= n_large) ) return;
+
+            for (size_type t = 0; t < tl; ++t)
+            {
+                size_type nsize = (t < nl) ? size_small << 1 : size_small;
+                if (nsize == bitmask(t)+1) continue;
+
+                auto ntab = make_aligned_array<bucket_type>(nsize);
+                migrate_grw(t, ntab, nsize-1);
+                llt[t] = std::move(ntab);
+            }
+
+            n_large      = nl;
+            capacity     = (n_large+tl) * size_small * bs;
+            bits_small   =  size_small - 1;
+            bits_large   = (size_small << 1) - 1;
+            grow_thresh  = std::ceil((capacity + (bits_large+1)*bs)/alpha);
+            shrnk_thresh = 0;
+        }
+
         iterator begin()
         {
-            auto temp = make_iterator(&llt[0][0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(llt[t].get(), bitmask(t)+1);
+                if (ptr) return make_iterator(ptr);
+            }
+            return base_type::stash_begin();
         }
 
         const_iterator cbegin() const
         {
-            auto temp = make_citerator(&llt[0][0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(llt[t].get(), bitmask(t)+1);
+                if (ptr) return make_citerator(ptr);
+            }
+            return base_type::stash_cbegin();
         }
 
     private:
@@ -165,6 +234,9 @@ namespace dysect
         inline size_type    bitmask(size_type tab) const
         { return (tab < n_large) ? bits_large : bits_small; }
 
+        std::pair<size_type, size_type> layout(size_type cap) const
+        { return dysect_layout<tl, bs>(cap, alpha); }
+
         inline void         get_buckets(hashed_type h, bucket_type** mem) const
         {
             for (size_type i = 0; i < nh; ++i)
@@ -180,12 +252,40 @@ namespace dysect
 
 
 
+        // Subtable fill counters (see cuckoo_base) ********************************
+
+        // b is one of the buckets of h, its subtable gained d elements
+        inline void fill_changed(hashed_type h, const bucket_type* b, int d)
+        {
+            for (size_type i = 0; i < nh; ++i)
+            {
+                if (get_bucket(h, i) == b) { ll_elem[ext::tab(h, i)] += d; return; }
+            }
+        }
+
+        inline void fill_reset()
+        {
+            for (size_type t = 0; t < tl; ++t)
+            {
+                ll_elem[t] = 0;
+                for (size_type i = 0; i <= bitmask(t); ++i) ll_elem[t] += llt[t][i].size();
+            }
+        }
+
+        inline double fill_ratio(hashed_type h, size_type i) const
+        {
+            size_type tab = ext::tab(h, i);
+            return double(ll_elem[tab]) / double((bitmask(tab)+1) * bs);
+        }
+
+
+
         // Size changes (GROWING) **************************************************
 
         inline void grow()
         {
-            auto   ntab  = std::make_unique<bucket_type[]>( bits_large + 1 );
-            migrate_grw(n_large, ntab);
+            auto   ntab  = make_aligned_array<bucket_type>( bits_large + 1 );
+            migrate_grw(n_large, ntab, bits_large);
 
             llt[n_large] = std::move(ntab);
 
@@ -196,33 +296,35 @@ namespace dysect
             shrnk_thresh = std::ceil((capacity - (bits_large+1)*bs)/alpha);
         }
 
-        inline void migrate_grw(size_type tab, std::unique_ptr<bucket_type[]>& target)
+        // moves subtable tab into target (with bitmask nbits, a superset of
+        // the current bitmask), each new bucket receives elements of only
+        // one old bucket
+        inline void migrate_grw(size_type tab, aligned_array<bucket_type>& target,
+                                size_type nbits)
         {
-            size_type flag = bits_small+1;
+            size_type obits = bitmask(tab);
 
-            for (size_type i = 0; i < flag; ++i)
+            for (size_type i = 0; i <= obits; ++i)
             {
                 bucket_type* curr = &(llt[tab][i]);
 
-                size_type tj0  = 0;
-                bucket_type* tar0 = &(target[i]);
-                size_type tj1  = 0;
-                bucket_type* tar1 = &(target[i+flag]);
+                size_type   cnt = curr->size();
+                hashed_type hashes[bs];
+                slot_hashes(curr, cnt, hashes);
 
-                for (size_type j = 0; j < bs; ++j)
+                for (size_type j = 0; j < cnt; ++j)
                 {
-                    auto e    = curr->elements[j];
-                    if (! e.first) break;
-                    auto hash = hasher(e.first);
+                    // the old subtable is discarded, elements are moved
+                    auto e    = std::move(curr->elements[j]);
+                    auto hash = hashes[j];
 
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         size_type loc = ext::loc(hash, ti);
                         if ( ext::tab(hash, ti) == tab &&
-                             (loc & bits_small) == i)
+                             (loc & obits) == i)
                         {
-                            if (loc & flag) tar1->elements[tj1++] = e;
-                            else            tar0->elements[tj0++] = e;
+                            target[loc & nbits].insert_ptr(std::move(e), hash);
                             break;
                         }
                     }
@@ -244,10 +346,11 @@ namespace dysect
         {
             if (n_large) { n_large--; }
             else         { n_large = tl-1; bits_small >>= 1; bits_large >>= 1; }
-            auto ntab = std::make_unique<bucket_type[]>(bits_small + 1);
-            std::vector<std::pair<key_type, mapped_type> > buffer;
+            auto ntab = make_aligned_array<bucket_type>(bits_small + 1);
+            std::vector<value_intern> buffer;
 
             migrate_shrnk( n_large, ntab, buffer );
+            ll_elem[n_large] -= buffer.size();
 
             llt[n_large] = std::move(ntab);
 
@@ -259,8 +362,8 @@ namespace dysect
             if (bits_small == 0 && !n_large) shrnk_thresh = 0;
         }
 
-        inline void migrate_shrnk(size_type tab, std::unique_ptr<bucket_type[]>& target,
-                                  std::vector<std::pair<key_type, mapped_type> >& buffer)
+        inline void migrate_shrnk(size_type tab, aligned_array<bucket_type>& target,
+                                  std::vector<value_intern>& buffer)
         {
             size_type flag = bits_small + 1;
 
@@ -269,19 +372,18 @@ namespace dysect
                 bucket_type* curr  = &(llt[tab][i]);
                 bucket_type* curr1 = &(llt[tab][i+flag]);
                 bucket_type* targ  = &(target[i]);
-                size_type ind = 0;
                 for (size_type j = 0; j < bs; ++j)
                 {
-                    auto e = curr->elements[j];
-                    if (! e.first) break;
-                    auto hash = hasher(e.first);
+                    if (! curr->occupied(j)) break;
+                    auto hash = slot_hash(curr, j);
+                    auto e    = std::move(curr->elements[j]);
 
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         if ( ext::tab(hash, ti)  == tab &&
                              (ext::loc(hash, ti) & bits_small) == i)
                         {
-                            targ->elements[ind++] = e;
+                            targ->insert_ptr(std::move(e), hash);
                             break;
                         }
                     }
@@ -289,20 +391,19 @@ namespace dysect
 
                 for (size_type j = 0; j < bs; ++j)
                 {
-                    auto e = curr1->elements[j];
-                    if (! e.first)
-                    { break; }
-                    else if (ind >= bs)
-                    { buffer.push_back(e); }
+                    if (! curr1->occupied(j)) break;
+                    if (! targ->space())
+                    { buffer.push_back(std::move(curr1->elements[j])); }
                     else
                     {
-                        auto hash = hasher(e.first);
+                        auto hash = slot_hash(curr1, j);
+                        auto e    = std::move(curr1->elements[j]);
                         for (size_type ti = 0; ti < nh; ++ti)
                         {
                             if ( ext::tab(hash, ti)  == tab &&
                                  (ext::loc(hash, ti) & bits_small) == i)
                             {
-                                targ->elements[ind++] = e;
+                                targ->insert_ptr(std::move(e), hash);
                                 break;
                             }
                         }
@@ -311,13 +412,13 @@ namespace dysect
             }
         }
 
-        inline void finish_shrnk(std::vector<std::pair<key_type, mapped_type> >& buffer)
+        inline void finish_shrnk(std::vector<value_intern>& buffer)
         {
             size_type err = 0;
             n -= buffer.size();
             for (auto& e : buffer)
             {
-                err += (base_type::insert(e).second) ? 1: 0;
+                err += (base_type::insert(std::move(e)).second) ? 1: 0;
             }
         }
 
@@ -341,11 +442,13 @@ namespace dysect
         using size_type        = size_t;
 
         static constexpr size_type tl = config_type::tl;
-        static constexpr size_type bs = config_type::bs;
         static constexpr size_type nh = config_type::nh;
 
         using hasher_type    = hasher<K, HF, ct_log(tl), nh, true, true>;
-        using bucket_type    = bucket<K,D,bs>;
+        static constexpr size_type bs = config_type::template slots<K,D,
+                                        typename hasher_type::hashed_type>();
+        using bucket_type    = typename config_type::template bucket_type<K,D,bs,
+                               typename hasher_type::hashed_type>;
 
     };
 
@@ -359,15 +462,15 @@ namespace dysect
     public:
         using table_type = cuckoo_dysect<K,D,HF,Conf>;
     private:
-        using size_type  = typename table_type::size_type;
-        using ipointer   = std::pair<const K,D>*;
+        using size_type   = typename table_type::size_type;
+        using bucket_type = typename table_type::bucket_type;
+        using ipointer    = typename element_traits<K,D>::value_type*;
         static constexpr size_type tl = Conf::tl;
-        static constexpr size_type bs = Conf::bs;
 
     public:
 
         iterator_incr(const table_type& table_)
-            : table(table_), end_tab(nullptr), tab(tl + 1)
+            : table(&table_), tab(tl + 1)
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
@@ -376,57 +479,30 @@ namespace dysect
         {
             if (tab > tl) initialize_tab(cur);
 
-            auto temp = cur+1;
-            if (temp > end_tab)
-            { temp = overflow_tab(); if (!temp) return nullptr; }
-
-            while (!temp->first)
+            auto temp = next_in_buckets(table->llt[tab].get(), table->bitmask(tab)+1, cur);
+            while (!temp && ++tab < tl)
             {
-                if (++temp > end_tab) return overflow_tab();
+                temp = first_in_buckets<ipointer>(table->llt[tab].get(),
+                                                  table->bitmask(tab)+1);
             }
             return temp;
         }
 
     private:
-        const table_type& table;
-        ipointer       end_tab;
-        size_type      tab;
-
-        ipointer overflow_tab()
-        {
-            if (++tab >= tl) return nullptr;
-            size_type size = (tab < table.n_large) ? table.bits_large : table.bits_small;
-            end_tab = reinterpret_cast<ipointer>(&table.llt[tab][size].elements[bs-1]);
-            return reinterpret_cast<ipointer>(&table.llt[tab][0].elements[0]);
-        }
+        const table_type* table;
+        size_type         tab;
 
         void initialize_tab(ipointer ptr)
         {
-            for (size_type i = 0; i < table.n_large; ++i)
-            {
-                ipointer tab_b_ptr = reinterpret_cast<ipointer>
-                    (&table.llt[i][0].elements[0]);
-                ipointer tab_e_ptr = reinterpret_cast<ipointer>
-                    (&table.llt[i][table.bits_large].elements[bs-1]);
-
-                if (tab_b_ptr <= ptr && ptr <= tab_e_ptr)
-                {
-                    tab = i;
-                    end_tab = tab_e_ptr;
-                    return;
-                }
-            }
-            for (size_type i = table.n_large; i < tl; ++i)
+            auto p = reinterpret_cast<const char*>(ptr);
+            for (size_type i = 0; i < tl; ++i)
             {
-                ipointer tab_b_ptr = reinterpret_cast<ipointer>
-                    (&table.llt[i][0].elements[0]);
-                ipointer tab_e_ptr = reinterpret_cast<ipointer>
-                    (&table.llt[i][table.bits_small].elements[bs-1]);
+                auto tab_b = reinterpret_cast<const char*>(table->llt[i].get());
+                auto tab_e = tab_b + (table->bitmask(i)+1) * sizeof(bucket_type);
 
-                if (tab_b_ptr <= ptr && ptr <= tab_e_ptr)
+                if (tab_b <= p && p < tab_e)
                 {
                     tab = i;
-                    end_tab = tab_e_ptr;
                     return;
                 }
             }
@@ -465,7 +541,7 @@ namespace dysect
         using size_type      = typename base_type::size_type;
 
     private:
-        using value_intern   = std::pair<key_type, mapped_type>;
+        using value_intern   = typename element_traits<key_type, mapped_type>::value_intern;
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
         static constexpr size_type tl = cuckoo_traits<this_type>::tl;
@@ -480,19 +556,10 @@ namespace dysect
                               size_type dis_steps = 0, size_type seed = 0)
             : base_type(size_constraint, dis_steps, seed)
         {
-            auto temp = static_cast<bucket_type*>(operator new (max_size));
-
-            table     = std::unique_ptr<bucket_type[]>(temp);
+            table     = make_aligned_buffer<bucket_type>(max_size);
 
-            double avg_size_f = double(cap) * size_constraint / double(tl*bs);
-
-            size_type size_small = 1;
-            while(avg_size_f > (size_small << 1))
-                size_small <<= 1;
-
-            n_large = (size_small < avg_size_f)
-                ? std::floor(double(cap) * alpha / double(size_small * bs))-tl
-                : 0;
+            size_type size_small;
+            std::tie(size_small, n_large) = layout(cap);
 
             for (size_type i = 0; i < n_large; ++i)
             {
@@ -513,6 +580,7 @@ namespace dysect
             bits_large  = (size_small << 1) - 1;
             grow_thresh = std::ceil((capacity + (bits_large+1)*bs)/alpha);
             shrnk_thresh= 0; // ensures no shrinking until grown at least once
+            std::fill(ll_elem, ll_elem+tl, 0);
         }
 
         cuckoo_dysect_inplace(const cuckoo_dysect_inplace&)            = delete;
@@ -527,13 +595,16 @@ namespace dysect
         using base_type::grow_thresh;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::slot_hash;
+        using base_type::slot_hashes;
 
         size_type n_large;
         size_type bits_small;
         size_type bits_large;
         size_type shrnk_thresh;
 
-        std::unique_ptr<bucket_type[]> table;
+        aligned_array<bucket_type> table;
+        size_type                  ll_elem[tl]; // elements per subtable
 
         static constexpr size_type tl_bitmask = tl - 1;
 
@@ -541,26 +612,76 @@ namespace dysect
         using base_type::make_citerator;
 
     public:
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
+        {
+            return (i < tl) ? std::make_pair(bitmask(i)+1, table_off(i))
+                : std::make_pair(size_type(0), nullptr);
+        }
+
+        // grows the table to the layout of cuckoo_dysect_inplace(cap) (see
+        // cuckoo_dysect::reserve), each subtable grows in place
+        void reserve(size_type cap)
+        {
+            size_type size_small, nl;
+            std::tie(size_small, nl) = layout(cap);
+            if (  size_small <  bits_small+1 ||
+                 (size_small == bits_small+1 && nl <= n_large) ) return;
+
+            for (size_type t = 0; t < tl; ++t)
+            {
+                size_type osize = bitmask(t)+1;
+                size_type nsize = (t < nl) ? size_small << 1 : size_small;
+                if (nsize == osize) continue;
+
+                bucket_type* offset = table_off(t);
+                std::fill(offset + osize, offset + nsize, bucket_type());
+                migrate_grw(t, osize-1, nsize-1);
+            }
+
+            n_large      = nl;
+            capacity     = (n_large+tl) * size_small * bs;
+            bits_small   =  size_small - 1;
+            bits_large   = (size_small << 1) - 1;
+            grow_thresh  = std::ceil((capacity + (bits_large+1)*bs)/alpha);
+            shrnk_thresh = 0;
+        }
+
         iterator begin()
         {
-            auto temp = make_iterator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(table_off(t), bitmask(t)+1);
+                if (ptr) return make_iterator(ptr);
+            }
+            return base_type::stash_begin();
         }
 
         const_iterator cbegin() const
         {
-            auto temp = make_citerator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(table_off(t), bitmask(t)+1);
+                if (ptr) return make_citerator(ptr);
+            }
+            return base_type::stash_cbegin();
         }
 
     private:
+        // the table is overallocated (max_size bytes, see stats())
+        void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_reserved = sizeof(*this) + max_size;
+        }
+
         // Functions for finding buckets *******************************************
 
         inline size_type    bitmask(size_type tab) const
         { return (tab < n_large) ? bits_large : bits_small; }
 
+        std::pair<size_type, size_type> layout(size_type cap) const
+        { return dysect_layout<tl, bs>(cap, alpha); }
+
         inline void         get_buckets(hashed_type h, bucket_type** mem) const
         {
             for (size_type i = 0; i < nh; ++i)
@@ -579,6 +700,34 @@ namespace dysect
             return table.get() + t*max_loc_size;
         }
 
+
+
+        // Subtable fill counters (see cuckoo_base) ********************************
+
+        // b is one of the buckets of h, its subtable gained d elements
+        inline void fill_changed(hashed_type h, const bucket_type* b, int d)
+        {
+            for (size_type i = 0; i < nh; ++i)
+            {
+                if (get_bucket(h, i) == b) { ll_elem[ext::tab(h, i)] += d; return; }
+            }
+        }
+
+        inline void fill_reset()
+        {
+            for (size_type t = 0; t < tl; ++t)
+            {
+                ll_elem[t] = 0;
+                for (size_type i = 0; i <= bitmask(t); ++i) ll_elem[t] += table_off(t)[i].size();
+            }
+        }
+
+        inline double fill_ratio(hashed_type h, size_type i) const
+        {
+            size_type tab = ext::tab(h, i);
+            return double(ll_elem[tab]) / double((bitmask(tab)+1) * bs);
+        }
+
         // Size changes (GROWING) **************************************************
 
         void grow()
@@ -589,7 +738,7 @@ namespace dysect
             bucket_type* new_e  = offset + (bits_large + 1);
             std::fill(new_s, new_e, bucket_type());
 
-            migrate_grw(n_large);
+            migrate_grw(n_large, bits_small, bits_large);
             //llt[n_large] = std::move(ntab);
 
             capacity    += (bits_small+1) * bs;
@@ -599,39 +748,43 @@ namespace dysect
             shrnk_thresh = std::ceil((capacity - (bits_large+1)*bs)/alpha);
         }
 
-        void migrate_grw(size_type tab)
+        // grows subtable tab in place from bitmask obits to nbits (buckets
+        // behind obits are empty), each new bucket receives elements of
+        // only one old bucket
+        void migrate_grw(size_type tab, size_type obits, size_type nbits)
         {
-            size_type flag = bits_small+1;
-
             bucket_type* b0 = table_off(tab);
-            bucket_type* b1 = b0 + flag;
 
-            for (size_type i = 0; i < flag; ++i, b0++, b1++)
+            for (size_type i = 0; i <= obits; ++i, b0++)
             {
-                size_type    k0  = 0;
-                size_type    k1  = 0;
+                size_type   cnt = b0->size();
+                hashed_type hashes[bs];
+                slot_hashes(b0, cnt, hashes);
 
-                for (size_type j = 0; j < bs; ++j)
+                for (size_type j = 0; j < cnt; )
                 {
-                    auto e    = b0->elements[j];
-                    if (! e.first) break;
-                    auto hash = hasher(e.first);
+                    auto hash = hashes[j];
+                    size_type target = i;
 
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         size_type loc = ext::loc(hash, ti);
                         if ( ext::tab(hash, ti) == tab &&
-                             (loc & bits_small) == i)
+                             (loc & obits) == i)
                         {
-                            if (loc & flag) b1->elements[k1++] = e;
-                            else            b0->elements[k0++] = e;
+                            target = loc & nbits;
                             break;
                         }
                     }
-                }
-                for (size_type j = k0; j < bs; ++j)
-                {
-                    b0->elements[j] = value_intern();
+
+                    // remove_at refills slot j with the last element of b0
+                    if (target != i)
+                    {
+                        table_off(tab)[target].insert_ptr(std::move(b0->elements[j]), hash);
+                        b0->remove_at(j);
+                        hashes[j] = hashes[--cnt];
+                    }
+                    else      { ++j; }
                 }
             }
         }
@@ -651,7 +804,7 @@ namespace dysect
         //     if (n_large) { n_large--; }
         //     else         { n_large = tl-1; bits_small >>= 1; bits_large >>= 1; }
         //     auto ntab = std::make_unique<bucket_type[]>(bits_small + 1);
-        //     std::vector<std::pair<key_type, mapped_type> > buffer;
+        //     std::vector<value_intern> buffer;
 
         //     migrate_shrnk( n_large, ntab, buffer );
 
@@ -666,7 +819,7 @@ namespace dysect
         // }
 
         // inline void migrate_shrnk(size_type tab, std::unique_ptr<bucket_type[]>& target,
-        //                           std::vector<std::pair<key_type, mapped_type> >& buffer)
+        //                           std::vector<value_intern>& buffer)
         // {
         //     size_type flag = bits_small + 1;
 
@@ -717,7 +870,7 @@ namespace dysect
         //     }
         // }
 
-        // inline void finish_shrnk(std::vector<std::pair<key_type, mapped_type> >& buffer)
+        // inline void finish_shrnk(std::vector<value_intern>& buffer)
         // {
         //     size_type bla = 0;
         //     n -= buffer.size();
@@ -747,11 +900,13 @@ namespace dysect
         using size_type        = size_t;
 
         static constexpr size_type tl = config_type::tl;
-        static constexpr size_type bs = config_type::bs;
         static constexpr size_type nh = config_type::nh;
 
         using hasher_type      = hasher<K, HF, ct_log(tl), nh, true, true>;
-        using bucket_type      = bucket<K,D,bs>;
+        static constexpr size_type bs = config_type::template slots<K,D,
+                                        typename hasher_type::hashed_type>();
+        using bucket_type      = typename config_type::template bucket_type<K,D,bs,
+                                 typename hasher_type::hashed_type>;
 
     };
 
@@ -765,68 +920,40 @@ namespace dysect
     public:
         using table_type = cuckoo_dysect_inplace<K,D,HF,Conf>;
     private:
-        using size_type  = typename table_type::size_type;
-        using ipointer   = std::pair<const K,D>*;
+        using size_type   = typename table_type::size_type;
+        using bucket_type = typename table_type::bucket_type;
+        using ipointer    = typename element_traits<K,D>::value_type*;
         static constexpr size_type tl = Conf::tl;
-        static constexpr size_type bs = Conf::bs;
 
     public:
         iterator_incr(const table_type& table_)
-            : table(table_), end_tab(nullptr), tab(tl + 1)
+            : table(&table_), tab(tl + 1)
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
 
         ipointer next(ipointer cur)
         {
-            if (tab > tl) initialize_tab(cur);
-
-            auto temp = cur+1;
-            if (temp > end_tab)
-            { temp = overflow_tab(); if (!temp) return nullptr; }
+            if (tab > tl)
+            {
+                // subtables are max_loc_size buckets apart
+                auto offset = reinterpret_cast<const char*>(cur)
+                    - reinterpret_cast<const char*>(table->table.get());
+                tab = offset / (table->max_loc_size * sizeof(bucket_type));
+            }
 
-            while (!temp->first)
+            auto temp = next_in_buckets(table->table_off(tab), table->bitmask(tab)+1, cur);
+            while (!temp && ++tab < tl)
             {
-                if (++temp > end_tab) return overflow_tab();
+                temp = first_in_buckets<ipointer>(table->table_off(tab),
+                                                  table->bitmask(tab)+1);
             }
             return temp;
         }
 
     private:
-        const table_type& table;
-        ipointer          end_tab;
+        const table_type* table;
         size_type         tab;
-
-        ipointer overflow_tab()
-        {
-            if (++tab >= tl) return nullptr;
-            auto tab_start = table.table.get() + tab*table.max_loc_size;
-            size_type size = (tab < table.n_large) ? table.bits_large : table.bits_small;
-            end_tab = reinterpret_cast<ipointer>(&(tab_start + size)->elements[bs-1]);
-            return reinterpret_cast<ipointer>(&tab_start->elements[0]);
-        }
-
-        void initialize_tab(ipointer ptr)
-        {
-            auto tab_curr = table.table.get();
-            if (ptr < reinterpret_cast<ipointer>(&tab_curr->elements[0])) return;
-
-            for (size_type i = 0; i < tl; ++i)
-            {
-                auto tab_size = (i < table.n_large) ? table.bits_large : table.bits_small;
-                auto bkt_last = tab_curr + tab_size;
-                auto par_last = reinterpret_cast<ipointer>(& bkt_last->elements[bs-1]);
-
-                //tab_offset += table.max_loc_size;
-                if (ptr <= par_last)
-                {
-                    tab = i;
-                    end_tab = par_last;
-                    return;
-                }
-            }
-        }
-
     };
 
 } // namespace dysect
@@ -50,7 +50,8 @@ namespace dysect
         using insert_return_type = typename base_type::insert_return_type;
 
     private:
-        using value_intern   = std::pair<key_type, mapped_type>;
+        using value_intern   = typename element_traits<key_type, mapped_type>::value_intern;
+        using mapped_param_type = typename element_traits<key_type, mapped_type>::mapped_param_type;
 
     public:
         cuckoo_independent_2lvl(size_type cap = 0      , double size_constraint = 1.1,
@@ -64,7 +65,7 @@ namespace dysect
 
             for (size_type i = 0; i < tl; ++i)
             {
-                ll_tab[i]    = std::make_unique<bucket_type[]>(lsize);
+                ll_tab[i]    = make_aligned_array<bucket_type>(lsize);
                 ll_size[i]   = lsize;
                 ll_elem[i]   = 0;
                 ll_thresh[i] = grow_thresh;
@@ -111,6 +112,8 @@ namespace dysect
         using base_type::capacity;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::lcounter;
+        using latency_scope = typename base_type::latency_scope;
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
         static constexpr size_type tl = cuckoo_traits<this_type>::tl;
@@ -122,7 +125,7 @@ namespace dysect
         size_type ll_elem  [tl];
         size_type ll_thresh[tl];
         double    ll_factor[tl];
-        std::unique_ptr<bucket_type[]> ll_tab[tl];
+        aligned_array<bucket_type> ll_tab[tl];
         std::vector<value_intern> grow_buffer;
 
         using base_type::make_iterator;
@@ -131,37 +134,29 @@ namespace dysect
     public:
         // Specialized Funcitions (to keep per table counts) ***********************
 
-        inline insert_return_type insert(const key_type k, const mapped_type d)
+        inline insert_return_type insert(const key_type k, const mapped_param_type d)
         {
-            return insert(std::make_pair(k,d));
+            return insert(element_traits<key_type, mapped_type>::make(k,d));
         }
 
-        inline insert_return_type insert(const std::pair<key_type, mapped_type> t)
+        inline insert_return_type insert(value_intern t)
         {
-            auto hash = hasher(t.first);
-            size_type ttl = ext::tab(hash, 0);
-
-            auto result = base_type::insert(t);
-            if (result.second)
-            {
-                auto currsize = ++ll_elem[ttl];
-                if (currsize > ll_thresh[ttl]) growTab(ttl);
-            }
-            return result;
+            return insert_hashed(std::move(t), hasher(t.first));
         }
 
-        size_type erase(const key_type k)
+        using base_type::insert_hashed;
+
+        // per table counts are kept by insert (no prefetching)
+        template<class InputIt>
+        inline size_type insert_batch(InputIt first, InputIt last)
         {
-            auto hash     = hasher(k);
-            size_type ttl    = ext::tab(hash, 0);
-            size_type nk     = base_type::erase(k);
-            ll_elem[ttl] -= nk;
-            return nk;
+            size_type inserted = 0;
+            for ( ; first != last; ++first)
+                if (insert(value_intern(*first)).second) ++inserted;
+            return inserted;
         }
 
-
-
-        std::pair<size_type, bucket_type*> getTable(size_type i)
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
         {
             return (i < tl) ? std::make_pair(ll_size[i], ll_tab[i].get())
                 : std::make_pair(0,nullptr);
@@ -169,33 +164,81 @@ namespace dysect
 
         iterator begin()
         {
-            auto temp = make_iterator(&ll_tab[0][0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(ll_tab[t].get(), ll_size[t]);
+                if (ptr) return make_iterator(ptr);
+            }
+            return base_type::stash_begin();
         }
 
         const_iterator cbegin() const
         {
-            auto temp = make_citerator(&ll_tab[0][0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type t = 0; t < tl; ++t)
+            {
+                auto ptr = first_in_buckets<value_intern*>(ll_tab[t].get(), ll_size[t]);
+                if (ptr) return make_citerator(ptr);
+            }
+            return base_type::stash_cbegin();
         }
 
     private:
         // Functions for finding buckets *******************************************
 
-        inline void getBuckets(hashed_type h, bucket_type** mem) const
+        inline void get_buckets(hashed_type h, bucket_type** mem) const
             {
                 for (size_type i = 0; i < nh; ++i)
-                    mem[i] = getBucket(h, i);
+                    mem[i] = get_bucket(h, i);
             }
 
-        inline bucket_type* getBucket (hashed_type h, size_type i) const
+        inline bucket_type* get_bucket (hashed_type h, size_type i) const
             {
                 size_type tab = ext::tab(h,0);
                 return &(ll_tab[tab][ext::loc(h,i)*ll_factor[tab]]);
             }
 
+        // the subtable of an element (and thus the element counts) would
+        // change, failed insertions are not retried with new hash functions
+        inline bool rehash(const value_intern&) { return false; }
+
+        // used by erase (also for heterogeneous keys, see cuckoo_base)
+        template<class LKey>
+        size_type erase_key(const LKey& k, hashed_type hash)
+        {
+            size_type ttl    = ext::tab(hash, 0);
+            size_type nk     = base_type::erase_key(k, hash);
+            ll_elem[ttl] -= nk;
+            return nk;
+        }
+
+        // used by insert_hashed, try_emplace, insert_or_assign and upsert (k
+        // can be moved into the new element, therefore it is copied)
+        template<class Make>
+        inline insert_return_type insert_with(const key_type& k, hashed_type hash, Make make)
+        {
+            latency_scope lat(lcounter, table_op::insert);
+            const key_type key = k;
+            auto result = base_type::insert_with(key, hash, make);
+            if (result.second) count_insert(key, hash, result);
+            return result;
+        }
+
+        // counts a new element k in its subtable (growing moves the element)
+        inline void count_insert(const key_type& k, hashed_type hash,
+                                 insert_return_type& result)
+        {
+            size_type ttl = ext::tab(hash, 0);
+            auto currsize = ++ll_elem[ttl];
+            if (currsize > ll_thresh[ttl])
+            {
+                {
+                    latency_scope lat(lcounter, table_op::grow);
+                    growTab(ttl);
+                }
+                result.first = base_type::find(k);
+            }
+        }
+
 
 
         // Size changes (GROWING) **************************************************
@@ -215,7 +258,7 @@ namespace dysect
             double nfactor = double(nsize)      / fac_div;
             size_type nthresh = ll_elem[tab] * beta;
 
-            auto ntable = std::make_unique<bucket_type[]>(nsize);
+            auto ntable = make_aligned_array<bucket_type>(nsize);
             migrate(tab, ntable, nfactor);
 
             ll_tab[tab]    = std::move(ntable);
@@ -225,7 +268,7 @@ namespace dysect
             if (grow_buffer.size()) finalize_grow();
         }
 
-        inline void migrate(size_type tab, std::unique_ptr<bucket_type[]>& target, double nfactor)
+        inline void migrate(size_type tab, aligned_array<bucket_type>& target, double nfactor)
         {
             size_type csize   = ll_size[tab];
             double cfactor = ll_factor[tab];
@@ -235,16 +278,18 @@ namespace dysect
 
                 for (size_type j = 0; j < bs; ++j)
                 {
-                    auto e    = curr.elements[j];
-                    if (! e.first) break;
+                    if (! curr.occupied(j)) break;
+                    // the old table is discarded, elements are moved
+                    auto e    = std::move(curr.elements[j]);
                     auto hash = hasher(e.first);
 
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         if (i == size_type(ext::loc(hash, ti) * cfactor))
                         {
-                            if (! target[ext::loc(hash, ti) * nfactor].insert(e))
-                                grow_buffer.push_back(e);
+                            bucket_type& tb = target[ext::loc(hash, ti) * nfactor];
+                            if (tb.space()) tb.insert_ptr(std::move(e), hash);
+                            else            grow_buffer.push_back(std::move(e));
                             break;
                         }
                     }
@@ -260,7 +305,7 @@ namespace dysect
                 base_type::insert(e);
             }
             n = temp;
-            std::vector<std::pair<key_type, mapped_type> > ttemp;
+            std::vector<value_intern> ttemp;
             std::swap(ttemp, grow_buffer);
         }
     };
@@ -286,6 +331,7 @@ namespace dysect
 
         using hasher_type       = hasher<K, HF, ct_log(tl), nh, true, true>;
         using bucket_type       = bucket<K,D,bs>;
+        static_assert(bs > 0, "cuckoo_independent_2lvl needs a fixed bucket size");
     };
 
 
@@ -296,15 +342,17 @@ namespace dysect
     class iterator_incr<cuckoo_independent_2lvl<K,D,HF,Conf> >
     {
     private:
-        using ipointer = std::pair<const K,D>*;
+        using ipointer = typename element_traits<K,D>::value_type*;
         static constexpr size_t tl = Conf::tl;
-        static constexpr size_t bs = Conf::bs;
 
     public:
         using table_type   = cuckoo_independent_2lvl<K,D,HF,Conf>;
+    private:
+        using bucket_type  = typename table_type::bucket_type;
 
+    public:
         iterator_incr(const table_type& table_)
-            : table(table_), end_tab(nullptr), tab(tl + 1)
+            : table(&table_), tab(tl + 1)
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
@@ -313,42 +361,30 @@ namespace dysect
         {
             if (tab > tl) initialize_tab(cur);
 
-            auto temp = cur+1;
-            if (temp > end_tab)
-            { temp = overflow_tab(); if (!temp) return nullptr; }
-
-            while (!temp->first)
+            auto temp = next_in_buckets(table->ll_tab[tab].get(), table->ll_size[tab], cur);
+            while (!temp && ++tab < tl)
             {
-                if (++temp > end_tab) return overflow_tab();
+                temp = first_in_buckets<ipointer>(table->ll_tab[tab].get(),
+                                                  table->ll_size[tab]);
             }
             return temp;
         }
 
     private:
-        const table_type& table;
-        ipointer          end_tab;
+        const table_type* table;
         size_t            tab;
 
-        ipointer overflow_tab()
-        {
-            if (++tab >= tl) return nullptr;
-            size_t size = table.ll_size[tab] - 1;
-            end_tab = reinterpret_cast<ipointer>(&table.ll_tab[tab][size].elements[bs-1]);
-            return reinterpret_cast<ipointer>(&table.ll_tab[tab][0].elements[0]);
-        }
-
         void initialize_tab(ipointer ptr)
         {
+            auto p = reinterpret_cast<const char*>(ptr);
             for (size_t i = 0; i < tl; ++i)
             {
-                ipointer tab_b_ptr = reinterpret_cast<ipointer>
-                    (&table.ll_tab[i][0].elements[0]);
-                ipointer tab_e_ptr = tab_b_ptr + table.ll_size[i]*bs;
+                auto tab_b = reinterpret_cast<const char*>(table->ll_tab[i].get());
+                auto tab_e = tab_b + table->ll_size[i] * sizeof(bucket_type);
 
-                if (tab_b_ptr <= ptr && ptr < tab_e_ptr)
+                if (tab_b <= p && p < tab_e)
                 {
                     tab = i;
-                    end_tab = tab_e_ptr;
                     return;
                 }
             }
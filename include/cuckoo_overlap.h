@@ -98,16 +98,16 @@ namespace dysect
 
         inline iterator begin()
         {
-            auto temp = make_iterator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type i = 0; i < capacity; ++i)
+                if (table[i].first != key_type()) return make_iterator(&table[i]);
+            return base_type::stash_begin();
         }
 
         inline const_iterator cbegin() const
         {
-            auto temp = make_citerator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type i = 0; i < capacity; ++i)
+                if (table[i].first != key_type()) return make_citerator(&table[i]);
+            return base_type::stash_cbegin();
         }
 
     private:
@@ -127,6 +127,14 @@ namespace dysect
             return reinterpret_cast<bucket_type*>(&(table[l*sbs]));
         }
 
+        // buckets overlap, therefore, they cannot be rehashed one by one
+        // (failed insertions are not retried with new hash functions)
+        inline bool rehash(const value_intern&) { return false; }
+
+        // buckets overlap, therefore, there are no bucket statistics
+        void add_stats(table_stats& s) const
+        { s.bytes_allocated += capacity*sizeof(value_intern); }
+
 
 
         // Size changes (GROWING) **************************************************
@@ -234,6 +242,7 @@ namespace dysect
 
         using hasher_type      = hasher<K, HF, 0, nh, true, true>;
         using bucket_type      = co_bucket<K,D,bs>;
+        static_assert(bs > 0, "cuckoo_overlap needs a fixed bucket size");
 
     };
 
@@ -367,16 +376,16 @@ namespace dysect
 
         inline iterator begin()
         {
-            auto temp = make_iterator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type i = 0; i < capacity; ++i)
+                if (table[i].first != key_type()) return make_iterator(&table[i]);
+            return base_type::stash_begin();
         }
 
         inline const_iterator cbegin() const
         {
-            auto temp = make_citerator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            for (size_type i = 0; i < capacity; ++i)
+                if (table[i].first != key_type()) return make_citerator(&table[i]);
+            return base_type::stash_cbegin();
         }
 
     private:
@@ -396,6 +405,18 @@ namespace dysect
             return reinterpret_cast<bucket_type*>(&(table[l*sbs]));
         }
 
+        // buckets overlap, therefore, they cannot be rehashed one by one
+        // (failed insertions are not retried with new hash functions)
+        inline bool rehash(const value_intern&) { return false; }
+
+        // buckets overlap, therefore, there are no bucket statistics, the
+        // table is overallocated (max_size bytes)
+        void add_stats(table_stats& s) const
+        {
+            s.bytes_allocated += capacity*sizeof(value_intern);
+            s.bytes_reserved   = sizeof(*this) + max_size;
+        }
+
 
 
         // Size changes (GROWING) **************************************************
@@ -507,6 +528,7 @@ namespace dysect
 
         using hasher_type      = hasher<K, HF, 0, nh, true, true>;
         using bucket_type      = co_bucket<K,D,bs>;
+        static_assert(bs > 0, "cuckoo_overlap needs a fixed bucket size");
 
     };
 
@@ -49,7 +49,7 @@ namespace dysect
         using const_iterator = typename base_type::const_iterator;
 
     private:
-        using value_intern = std::pair<key_type, mapped_type>;
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
 
     public:
         cuckoo_standard(size_type cap = 0      , double size_constraint = 1.1,
@@ -65,7 +65,7 @@ namespace dysect
 
             factor      = double(n_buckets)/double(1ull<<32);
 
-            table       = std::make_unique<bucket_type[]>(n_buckets);
+            table       = make_aligned_array<bucket_type>(n_buckets);
         }
 
         cuckoo_standard(const cuckoo_standard&) = delete;
@@ -80,6 +80,7 @@ namespace dysect
         using base_type::grow_thresh;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::slot_hash;
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
         static constexpr size_type nh = cuckoo_traits<this_type>::nh;
@@ -89,7 +90,7 @@ namespace dysect
         double beta;
         double factor;
 
-        std::unique_ptr<bucket_type[]> table;
+        aligned_array<bucket_type> table;
         std::vector<value_intern> grow_buffer;
 
         using base_type::make_iterator;
@@ -98,7 +99,7 @@ namespace dysect
     public:
         using base_type::insert;
 
-        std::pair<size_type, bucket_type*> getTable(size_type i)
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
         {
             return (! i) ? std::make_pair(n_buckets, table.get())
                 : std::make_pair(0,nullptr);
@@ -106,16 +107,14 @@ namespace dysect
 
         inline iterator begin()
         {
-            auto temp = make_iterator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            auto ptr = first_in_buckets<value_intern*>(table.get(), n_buckets);
+            return (ptr) ? make_iterator(ptr) : base_type::stash_begin();
         }
 
         inline const_iterator cbegin() const
         {
-            auto temp = make_citerator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            auto ptr = first_in_buckets<value_intern*>(table.get(), n_buckets);
+            return (ptr) ? make_citerator(ptr) : base_type::stash_cbegin();
         }
 
     private:
@@ -143,14 +142,18 @@ namespace dysect
         {
             if (grow_buffer.size()) return;
             size_type nsize = size_type(double(n)*alpha) / bs;
+            // grows before the threshold (failed insertions) add at least
+            // 1/8 of the buckets, the next threshold depends on the capacity
+            if (n <= grow_thresh) nsize = std::max(nsize, n_buckets + (n_buckets>>3));
             nsize        = std::max(nsize, n_buckets+1);
             capacity     = nsize*bs;
             double nfactor = double(nsize)/double(1ull << 32);
-            size_type nthresh = n * beta;
+            size_type nthresh = std::max(size_type(n * beta),
+                                         size_type(capacity * beta / alpha));
 
             //std::cout << n << " " << n_buckets << " -> " << nsize << std::endl;
 
-            auto ntable = std::make_unique<bucket_type[]>(nsize);
+            auto ntable = make_aligned_array<bucket_type>(nsize);
             migrate(ntable, nfactor);
 
             n_buckets   = nsize;
@@ -160,7 +163,7 @@ namespace dysect
             if (grow_buffer.size()) finalize_grow();
         }
 
-        inline void migrate(std::unique_ptr<bucket_type[]>& target, double nfactor)
+        inline void migrate(aligned_array<bucket_type>& target, double nfactor)
         {
             for (size_type i = 0; i < n_buckets; ++i)
             {
@@ -168,17 +171,17 @@ namespace dysect
 
                 for (size_type j = 0; j < bs; ++j)
                 {
-                    auto e = curr.elements[j];
-                    if (! e.first) break;
-                    auto hash = hasher(e.first);
+                    if (! curr.occupied(j)) break;
+                    // the old table is discarded, elements are moved
+                    auto hash = slot_hash(&curr, j);
+                    auto e    = std::move(curr.elements[j]);
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         if (i == size_type(ext::loc(hash, ti)*factor))
                         {
-                            if (! target[ext::loc(hash, ti) * nfactor].insert(e.first, e.second))
-                            {
-                                grow_buffer.push_back(e);
-                            }
+                            bucket_type& tb = target[ext::loc(hash, ti) * nfactor];
+                            if (tb.space()) tb.insert_ptr(std::move(e), hash);
+                            else            grow_buffer.push_back(std::move(e));
                             break;
                         }
                     }
@@ -186,17 +189,24 @@ namespace dysect
             }
         }
 
+        // while growing, elements that do not fit are reinserted (see
+        // finalize_grow), there is no rehashing during this phase
+        inline bool rehash(const value_intern& t)
+        {
+            return (grow_buffer.size()) ? false : base_type::rehash(t);
+        }
+
+        // the buffer is emptied first, s.t. reinsertions that need a
+        // rehash (or another grow) do not fail
         inline void finalize_grow()
         {
-            size_type temp = n;
-            for (auto& e : grow_buffer)
-            {
-                insert(e);
-            }
-            n = temp;
             std::vector<value_intern> tbuf;
-            //grow_buffer.clear();
             std::swap(tbuf, grow_buffer);
+            n -= tbuf.size();
+            for (auto& e : tbuf)
+            {
+                insert(std::move(e));
+            }
         }
     };
 
@@ -218,11 +228,13 @@ namespace dysect
         using mapped_type   = D;
 
         static constexpr size_type tl = 1;
-        static constexpr size_type bs = Conf::bs;
         static constexpr size_type nh = Conf::nh;
 
         using hasher_type      = hasher<K, HF, 0, nh, true, true>;
-        using bucket_type      = bucket<K,D,bs>;
+        static constexpr size_type bs = Conf::template slots<K,D,
+                                        typename hasher_type::hashed_type>();
+        using bucket_type      = typename Conf::template bucket_type<K,D,bs,
+                                 typename hasher_type::hashed_type>;
 
     };
 
@@ -237,28 +249,22 @@ namespace dysect
         using table_type = cuckoo_standard<K,D,HF,Conf>;
     private:
         using size_type  = typename table_type::size_type;
-        using pointer    = std::pair<const K,D>*;
-        static constexpr size_type bs = Conf::bs;
+        using pointer    = typename element_traits<K,D>::value_type*;
 
     public:
         iterator_incr(const table_type& table_)
-            : end_ptr(reinterpret_cast<pointer>
-                      (&table_.table[table_.n_buckets-1].elements[bs-1]))
+            : table(&table_)
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
 
         pointer next(pointer cur)
         {
-            while (cur < end_ptr)
-            {
-                if ((++cur)->first) return cur;
-            }
-            return nullptr;
+            return next_in_buckets(table->table.get(), table->n_buckets, cur);
         }
 
     private:
-        pointer end_ptr;
+        const table_type* table;
     };
 
 
@@ -299,7 +305,7 @@ namespace dysect
         using const_iterator = typename base_type::const_iterator;
 
     private:
-        using value_intern = std::pair<key_type, mapped_type>;
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
 
 
         static constexpr size_type bs = cuckoo_traits<this_type>::bs;
@@ -314,8 +320,7 @@ namespace dysect
             : base_type(size_constraint, dis_steps, seed),
               beta((size_constraint + 1.)/2.)
         {
-            auto temp = reinterpret_cast<bucket_type*>(operator new (max_size));
-            table = std::unique_ptr<bucket_type[]>(temp);
+            table = make_aligned_buffer<bucket_type>(max_size);
 
             n_buckets   = size_type(double(cap)*size_constraint)/bs;
             n_buckets   = std::max<size_type>(n_buckets, 256);
@@ -341,12 +346,13 @@ namespace dysect
         using base_type::grow_thresh;
         using base_type::alpha;
         using base_type::hasher;
+        using base_type::slot_hash;
 
         size_type n_buckets;
         double    beta;
         double    factor;
 
-        std::unique_ptr<bucket_type[]> table;
+        aligned_array<bucket_type> table;
         std::vector<value_intern>   grow_buffer;
 
         using base_type::make_iterator;
@@ -355,7 +361,7 @@ namespace dysect
     public:
         using base_type::insert;
 
-        std::pair<size_type, bucket_type*> getTable(size_type i)
+        std::pair<size_type, bucket_type*> getTable(size_type i) const
         {
             return (! i) ? std::make_pair(n_buckets, table.get())
                 : std::make_pair(0,nullptr);
@@ -363,19 +369,24 @@ namespace dysect
 
         inline iterator begin()
         {
-            auto temp = make_iterator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            auto ptr = first_in_buckets<value_intern*>(table.get(), n_buckets);
+            return (ptr) ? make_iterator(ptr) : base_type::stash_begin();
         }
 
         inline const_iterator cbegin() const
         {
-            auto temp = make_citerator(&table[0].elements[0]);
-            if (! temp->first) temp++;
-            return temp;
+            auto ptr = first_in_buckets<value_intern*>(table.get(), n_buckets);
+            return (ptr) ? make_citerator(ptr) : base_type::stash_cbegin();
         }
 
     private:
+        // the table is overallocated (max_size bytes, see stats())
+        void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_reserved = sizeof(*this) + max_size;
+        }
+
         // Functions for finding buckets *******************************************
 
         inline void get_buckets(hashed_type h, bucket_type** mem) const
@@ -402,10 +413,14 @@ namespace dysect
 
             if (grow_buffer.size()) return;
             size_type nsize   = size_type(double(n)*alpha) / bs;
+            // grows before the threshold (failed insertions) add at least
+            // 1/8 of the buckets, the next threshold depends on the capacity
+            if (n <= grow_thresh) nsize = std::max(nsize, n_buckets + (n_buckets>>3));
             nsize             = std::max(nsize, n_buckets+1);
             capacity          = nsize*bs;
             double    nfactor = double(nsize)/double(1ull << 32);
-            size_type nthresh = n * beta;
+            size_type nthresh = std::max(size_type(n * beta),
+                                         size_type(capacity * beta / alpha));
 
             //std::cout << n << " " << n_buckets << " -> " << nsize << std::endl;
 
@@ -432,20 +447,18 @@ namespace dysect
 
                 for (size_type j = 0; j < bs; ++j)
                 {
-                    auto e = curr.elements[j];
-                    if (! e.first) break;
-                    auto hash = hasher(e.first);
+                    if (! curr.occupied(j)) break;
+                    auto hash = slot_hash(&curr, j);
+                    auto e    = std::move(curr.elements[j]);
 
                     for (size_type ti = 0; ti < nh; ++ti)
                     {
                         if (i == int (ext::loc(hash, ti)*factor))
                         {
                             auto nbucket = ext::loc(hash,ti) * nfactor;
-                            if (    (i == nbucket)
-                                    || (! table[nbucket].insert(e.first, e.second)) )
-                            {
-                                grow_buffer.push_back(e);
-                            }
+                            bucket_type& tb = table[nbucket];
+                            if ((i != nbucket) && tb.space()) tb.insert_ptr(std::move(e), hash);
+                            else                              grow_buffer.push_back(std::move(e));
                             break;
                         }
                     }
@@ -454,17 +467,24 @@ namespace dysect
             }
         }
 
+        // while growing, elements that do not fit are reinserted (see
+        // finalize_grow), there is no rehashing during this phase
+        inline bool rehash(const value_intern& t)
+        {
+            return (grow_buffer.size()) ? false : base_type::rehash(t);
+        }
+
+        // the buffer is emptied first, s.t. reinsertions that need a
+        // rehash (or another grow) do not fail
         inline void finalize_grow()
         {
-            size_type temp = n;
-            for (auto& e : grow_buffer)
-            {
-                insert(e);
-            }
-            n = temp;
             std::vector<value_intern> tbuf;
-            //grow_buffer.clear();
             std::swap(tbuf, grow_buffer);
+            n -= tbuf.size();
+            for (auto& e : tbuf)
+            {
+                insert(std::move(e));
+            }
         }
     };
 
@@ -486,11 +506,13 @@ namespace dysect
         using mapped_type   = D;
 
         static constexpr size_type tl = 1;
-        static constexpr size_type bs = Conf::bs;
         static constexpr size_type nh = Conf::nh;
 
         using hasher_type      = hasher<K, HF, 0, nh, true, true>;
-        using bucket_type      = bucket<K,D,bs>;
+        static constexpr size_type bs = Conf::template slots<K,D,
+                                        typename hasher_type::hashed_type>();
+        using bucket_type      = typename Conf::template bucket_type<K,D,bs,
+                                 typename hasher_type::hashed_type>;
 
     };
 
@@ -505,28 +527,22 @@ namespace dysect
         using table_type = cuckoo_standard_inplace<K,D,HF,Conf>;
     private:
         using size_type  = typename table_type::size_type;
-        using pointer    = std::pair<const K,D>*;
-        static constexpr size_type bs = Conf::bs;
+        using pointer    = typename element_traits<K,D>::value_type*;
 
     public:
         iterator_incr(const table_type& table_)
-            : end_ptr(reinterpret_cast<pointer>
-                      (&table_.table[table_.n_buckets-1].elements[bs-1]))
+            : table(&table_)
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
 
         pointer next(pointer cur)
         {
-            while (cur < end_ptr)
-            {
-                if ((++cur)->first) return cur;
-            }
-            return nullptr;
+            return next_in_buckets(table->table.get(), table->n_buckets, cur);
         }
 
     private:
-        pointer end_ptr;
+        const table_type* table;
     };
 
 
@@ -544,6 +560,10 @@ namespace dysect
     public:
         using key_type       = typename subtable_type::key_type;
         using mapped_type    = typename subtable_type::mapped_type;
+    private:
+        using value_intern   = typename element_traits<key_type, mapped_type>::value_intern;
+        using mapped_param_type = typename element_traits<key_type, mapped_type>::mapped_param_type;
+    public:
 
         using iterator       = typename subtable_type::iterator;
         using const_iterator = typename subtable_type::const_iterator;
@@ -563,12 +583,12 @@ namespace dysect
             }
         }
 
-        inline std::pair<iterator,bool> insert(key_type k, mapped_type d)
+        inline std::pair<iterator,bool> insert(key_type k, mapped_param_type d)
         {
-            return insert(std::make_pair(k,d));
+            return insert(element_traits<key_type, mapped_type>::make(k,d));
         }
 
-        inline std::pair<iterator,bool> insert(std::pair<key_type,mapped_type> t)
+        inline std::pair<iterator,bool> insert(value_intern t)
         {
             return tables[getInd(t.first)].insert(t);
         }
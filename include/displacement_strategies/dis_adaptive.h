@@ -0,0 +1,114 @@
+#pragma once
+
+/*******************************************************************************
+ * include/displacement_strategies/dis_adaptive.h
+ *
+ * dis_adaptive switches between a short random walk (cheap at low load)
+ * and bfs (finds paths at high load).  The walk (at most walk_steps
+ * steps) is used while the table load is below load_threshold and while
+ * less than a fraction fail_threshold of the walks fails.  The failure
+ * rate is measured over windows of window walks, after a window with
+ * too many failures, the next window of displacements uses bfs, then
+ * walks are tried again (e.g. after a DySECT subtable grew).  Failed
+ * walks leave t unchanged and are retried with bfs, therefore, the
+ * walk never causes failed insertions.
+ *
+ * Both thresholds can be changed at runtime (set_thresholds), the
+ * strategy is accessed through displacement() of the table.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <utility>
+
+#include "dis_bfs1.h"
+#include "dis_random_walk_optimistic.h"
+
+namespace dysect
+{
+namespace cuckoo_displacement
+{
+
+    template<class Parent>
+    class dis_adaptive
+    {
+    private:
+        using value_intern = typename Parent::value_intern;
+        using hashed_type  = typename Parent::hashed_type;
+
+        using walk_type    = dis_random_walk_optimistic<Parent>;
+        using bfs_type     = dis_bfs1<Parent>;
+
+        static constexpr size_t walk_steps = 16;
+        static constexpr size_t window     = 1024;
+
+        Parent&   tab;
+        walk_type walk;
+        bfs_type  bfs;
+
+        double    load_thresh;
+        double    fail_thresh;
+        size_t    n_tries;   // displacements in the current window
+        size_t    n_fails;   // failed walks in the current window
+        bool      bfs_only;  // the last window had too many failed walks
+
+    public:
+        dis_adaptive(Parent& parent, size_t steps = 256,
+                     size_t seed = 30982391937209388ull)
+            : tab(parent), walk(parent, (steps < walk_steps) ? steps : walk_steps, seed),
+              bfs(parent, steps, seed), load_thresh(.9), fail_thresh(.1),
+              n_tries(0), n_fails(0), bfs_only(false)
+        { }
+
+        dis_adaptive(Parent& parent, dis_adaptive&& rhs)
+            : tab(parent), walk(parent, std::move(rhs.walk)),
+              bfs(parent, std::move(rhs.bfs)),
+              load_thresh(rhs.load_thresh), fail_thresh(rhs.fail_thresh),
+              n_tries(rhs.n_tries), n_fails(rhs.n_fails), bfs_only(rhs.bfs_only)
+        { }
+
+        // walks are used below load (n/capacity), and while less than a
+        // fraction fail_rate of them fails
+        void set_thresholds(double load, double fail_rate)
+        {
+            load_thresh = load;
+            fail_thresh = fail_rate;
+        }
+
+        double load_threshold() const { return load_thresh; }
+        double fail_threshold() const { return fail_thresh; }
+        bool   uses_bfs()       const
+        { return bfs_only || double(tab.n) >= load_thresh * double(tab.capacity); }
+
+        // t is moved into the table, it is unchanged if no path is found
+        inline std::pair<int, value_intern*>
+        insert(value_intern& t, hashed_type hash)
+        {
+            if (uses_bfs())
+            {
+                if (bfs_only && ++n_tries == window) next_window();
+                return bfs.insert(t, hash);
+            }
+
+            auto result = walk.insert(t, hash);
+            if (result.first < 0) ++n_fails;
+            if (++n_tries == window) next_window();
+
+            return (result.first < 0) ? bfs.insert(t, hash) : result;
+        }
+
+    private:
+        inline void next_window()
+        {
+            bfs_only = !bfs_only && double(n_fails) > fail_thresh * double(window);
+            n_tries  = 0;
+            n_fails  = 0;
+        }
+    };
+
+} // namespace cuckoo_displacement
+} // namespace dysect
@@ -3,7 +3,8 @@
 /*******************************************************************************
  * include/displacement_strategies/dis_bfs0.h
  *
- * dis_bfs0 implements the bfs displacement strategy.
+ * dis_bfs0 implements the bfs displacement strategy.  The bfs queue is
+ * kept between insertions (no allocation per displacement).
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -15,6 +16,7 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
+#include <utility>
 
 namespace dysect
 {
@@ -27,45 +29,48 @@ namespace cuckoo_displacement
     private:
         using key_type       = typename Parent::key_type;
         using mapped_type    = typename Parent::mapped_type;
-        using value_intern   = std::pair<key_type,mapped_type>;
-        using parent_type    = typename Parent::This_t;
+        using value_intern   = typename Parent::value_intern;
+        using parent_type    = typename Parent::this_type;
         using hashed_type    = typename Parent::hashed_type;
         using bucket_type    = typename Parent::bucket_type;
 
-        using bfs_queue      = std::vector<std::tuple<key_type, int, bucket_type*> >;
+        using bfs_item       = std::tuple<key_type, hashed_type, int, bucket_type*>;
+        using bfs_queue      = std::vector<bfs_item>;
 
         Parent&      tab;
         const size_t steps;
         static constexpr size_t nh = parent_type::nh;
+        bfs_queue    bq;
 
     public:
         dis_bfs0(Parent& parent, size_t steps = 256, size_t = 0)
             : tab(parent), steps(steps+1)
         {
             /* parameter is for symmetry with "rwalk" therefore unused*/
+            bq.reserve(this->steps + nh);
         }
 
         dis_bfs0(Parent& parent, dis_bfs0&& rhs)
-            : tab(parent), steps(rhs.steps)
+            : tab(parent), steps(rhs.steps), bq(std::move(rhs.bq))
         { }
 
-        inline std::pair<int, value_intern*> insert(std::pair<key_type,mapped_type> t, hashed_type hash)
+        inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
         {
-            bfs_queue  bq;
-
             bucket_type* b[nh];
+
+            bq.clear();
             tab.get_buckets(hash, b);
 
             for (size_t i = 0; i < nh; ++i)
             {
-                bq.push_back(std::tuple<key_type, int, bucket_type*>(t.first, -1, b[i]));
+                bq.push_back(bfs_item(t.first, hash, -1, b[i]));
             }
 
             for (size_t i = 0; i < steps; ++i)
             {
                 if (expand(bq, i))
                 {
-                    value_intern* pos = rollBackDisplacements(t, bq);
+                    value_intern* pos = rollBackDisplacements(std::move(t), bq);
                     return std::make_pair((pos) ? bq.size()-nh : -1, pos);
                 }
             }
@@ -76,13 +81,13 @@ namespace cuckoo_displacement
     private:
         inline bool expand(bfs_queue& q, size_t index)
         {
-            bucket_type* b = std::get<2>(q[index]);
+            bucket_type* b = std::get<3>(q[index]);
 
             for (size_t i = 0; i < tab.bs && q.size() < steps; ++i)
             {
                 key_type k = b->get(i).first;
 
-                auto hash = tab.hasher(k);
+                auto hash = tab.slot_hash(b, i);
 
                 bucket_type* ptr[nh];
                 tab.get_buckets(hash, ptr);
@@ -91,7 +96,7 @@ namespace cuckoo_displacement
                     if (ptr[ti] != b) // POTENTIAL BUG!!! continous bucket problem
                     {
                         //if (overwatch) std::cout << i << " " << ti << std::endl;
-                        q.emplace_back(k, index, ptr[ti]);
+                        q.emplace_back(k, hash, index, ptr[ti]);
                         if (ptr[ti]->space()) return true;
                     }
                 }
@@ -99,28 +104,30 @@ namespace cuckoo_displacement
             return false;
         }
 
-        inline value_intern* rollBackDisplacements(std::pair<key_type,mapped_type> t, bfs_queue& bq)
+        inline value_intern* rollBackDisplacements(value_intern t, bfs_queue& bq)
         {
             key_type     k1;
+            hashed_type  h1;
             int          prev1;
             bucket_type* b1;
-            std::tie(k1, prev1, b1) = bq[bq.size()-1];
+            std::tie(k1, h1, prev1, b1) = bq[bq.size()-1];
 
             key_type     k2;
+            hashed_type  h2;
             int          prev2;
             bucket_type* b2;
             while (prev1 >= 0)
             {
-                std::tie(k2,prev2,b2) = bq[prev1];
-
-                auto pop = b2->pop(k1);
+                std::tie(k2,h2,prev2,b2) = bq[prev1];
 
-                b1->insert(k1, pop.second);
+                value_intern* e = b2->find_ptr(k1, h1);
+                b1->insert_ptr(std::move(*e), h1);
+                b2->remove_at(e - b2->elements);
 
-                k1 = k2; prev1 = prev2; b1 = b2;
+                k1 = k2; h1 = h2; prev1 = prev2; b1 = b2;
             }
 
-            return b1->insert_ptr(t);
+            return b1->insert_ptr(std::move(t), h1);
         }
     };
 
@@ -4,7 +4,8 @@
  * include/displacement_strategies/dis_bfs1.h
  *
  * dis_bfs1 implements the bfs displacement strategy. This variant
- * is necessary for the overlapping buckets implementation.
+ * is necessary for the overlapping buckets implementation.  The bfs
+ * queue is kept between insertions (no allocation per displacement).
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -16,6 +17,7 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
+#include <utility>
 
 namespace dysect
 {
@@ -28,48 +30,59 @@ namespace cuckoo_displacement
     private:
         using key_type       = typename Parent::key_type;
         using mapped_type    = typename Parent::mapped_type;
-        using value_intern   = std::pair<key_type,mapped_type>;
+        using value_intern   = typename Parent::value_intern;
         using parent_type    = typename Parent::this_type;
         using hashed_type    = typename Parent::hashed_type;
         using bucket_type    = typename Parent::bucket_type;
 
 
-        using bfs_item       = std::tuple<value_intern*, int, bucket_type*>;
+        // element from->elements[slot] (t for the roots) moves to bucket to
+        struct bfs_item
+        {
+            bucket_type* from;
+            size_t       slot;
+            int          prev;
+            bucket_type* to;
+            hashed_type  hash;
+        };
         using bfs_queue      = std::vector<bfs_item>;
 
         Parent&      tab;
         const size_t steps;
         static constexpr size_t nh = parent_type::nh;
+        bfs_queue    bq;
 
     public:
         dis_bfs1(Parent& parent, size_t steps = 256, size_t = 0)
             : tab(parent), steps(steps+1)
-        { /* parameter is for symmetry with "rwalk" therefore unused*/ }
+        {
+            /* parameter is for symmetry with "rwalk" therefore unused*/
+            bq.reserve(this->steps + nh);
+        }
 
         dis_bfs1(Parent& parent, dis_bfs1&& rhs)
-            : tab(parent), steps(rhs.steps)
+            : tab(parent), steps(rhs.steps), bq(std::move(rhs.bq))
         { }
 
+        // t is moved into the table, it is unchanged if no path is found
         inline std::pair<int, value_intern*>
-        insert(value_intern t, hashed_type hash)
+        insert(value_intern& t, hashed_type hash)
         {
-            bfs_queue  bq;
             bucket_type* b[nh];
 
+            bq.clear();
             tab.get_buckets(hash, b);
 
-            value_intern t_copy = t;
-
             for (size_t i = 0; i < nh; ++i)
             {
-                bq.push_back(bfs_item(&t_copy, -1, b[i]));
+                bq.push_back(bfs_item{nullptr, 0, -1, b[i], hash});
             }
 
             for (size_t i = 0; i < steps; ++i)
             {
                 if (expand(bq, i))
                 {
-                    value_intern* pos = rollBackDisplacements(bq);
+                    value_intern* pos = rollBackDisplacements(bq, t);
                     return std::make_pair((pos) ? bq.size()-nh : -1, pos);
                 }
             }
@@ -80,14 +93,11 @@ namespace cuckoo_displacement
     private:
         inline bool expand(bfs_queue& q, size_t index)
         {
-            bucket_type* b = std::get<2>(q[index]);
+            bucket_type* b = q[index].to;
 
             for (size_t i = 0; i < tab.bs && q.size() < steps; ++i)
             {
-                value_intern* current = &(b->elements[i]);
-                key_type      k       = current->first;
-
-                auto hash = tab.hasher(k);
+                auto hash = tab.slot_hash(b, i);
 
                 bucket_type* ptr[nh];
                 tab.get_buckets(hash, ptr);
@@ -96,7 +106,7 @@ namespace cuckoo_displacement
                     if (ptr[ti] != b) // POTENTIAL BUG!!! continous bucket problem
                     {
                         //if (overwatch) std::cout << i << " " << ti << std::endl;
-                        q.emplace_back(current, index, ptr[ti]);
+                        q.push_back(bfs_item{b, i, int(index), ptr[ti], hash});
                         if (ptr[ti]->space()) return true;
                     }
                 }
@@ -104,31 +114,27 @@ namespace cuckoo_displacement
             return false;
         }
 
-        inline value_intern* rollBackDisplacements(bfs_queue& bq)
+        // elements are moved along the path (each slot is overwritten
+        // right after its element was moved)
+        inline value_intern* rollBackDisplacements(bfs_queue& bq,
+                                                   value_intern& t)
         {
-            value_intern* k1;
-            int           prev1;
-            bucket_type*  b1;
-            std::tie(k1, prev1, b1) = bq[bq.size()-1];
-
-            value_intern* t = b1->probe_ptr(key_type()).second;
-            (*t) = *k1;
-
-            value_intern* k2;
-            int           prev2;
-            bucket_type*  b2;
+            bfs_item curr = bq[bq.size()-1];
+            curr.to->insert_ptr(std::move(curr.from->elements[curr.slot]), curr.hash);
+            tab.count_fill(curr.hash, curr.to, 1);
 
-            value_intern* k0 = nullptr;
-            while (prev1 >= 0)
+            value_intern* pos = nullptr;
+            while (curr.prev >= 0)
             {
-                std::tie(k2,prev2,b2) = bq[prev1];
-                (*k1) = *k2;
+                const bfs_item& prev = bq[curr.prev];
+                value_intern& e = (prev.from) ? prev.from->elements[prev.slot] : t;
+                curr.from->replace(curr.slot, std::move(e), prev.hash);
 
-                k0 = k1;
-                k1 = k2; prev1 = prev2; b1 = b2;
+                pos  = &(curr.from->elements[curr.slot]);
+                curr = prev;
             }
 
-            return k0;
+            return pos;
         }
 
     };
@@ -0,0 +1,165 @@
+#pragma once
+
+/*******************************************************************************
+ * include/displacement_strategies/dis_bfs_frontier.h
+ *
+ * dis_bfs_frontier implements the bfs displacement strategy level by
+ * level.  All elements of the current level are hashed (the elements of
+ * one bucket at once, see slot_hashes) and all their buckets are
+ * prefetched, before any of these buckets is checked for free space.
+ * Thus, the cache misses of one level overlap (dis_bfs1 waits for each
+ * bucket in turn).  The explored buckets and the path are the same as
+ * with dis_bfs1.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <vector>
+#include <utility>
+
+#include "../cache_line.h"
+
+namespace dysect
+{
+namespace cuckoo_displacement
+{
+
+    template<class Parent>
+    class dis_bfs_frontier
+    {
+    private:
+        using key_type       = typename Parent::key_type;
+        using mapped_type    = typename Parent::mapped_type;
+        using value_intern   = typename Parent::value_intern;
+        using parent_type    = typename Parent::this_type;
+        using hashed_type    = typename Parent::hashed_type;
+        using bucket_type    = typename Parent::bucket_type;
+
+
+        // element from->elements[slot] (t for the roots) moves to bucket to
+        struct bfs_item
+        {
+            bucket_type* from;
+            size_t       slot;
+            int          prev;
+            bucket_type* to;
+            hashed_type  hash;
+        };
+        using bfs_queue      = std::vector<bfs_item>;
+
+        Parent&      tab;
+        const size_t steps;
+        static constexpr size_t nh = parent_type::nh;
+        static constexpr size_t bs = parent_type::bs;
+        bfs_queue    bq;
+
+    public:
+        dis_bfs_frontier(Parent& parent, size_t steps = 256, size_t = 0)
+            : tab(parent), steps(steps+1)
+        {
+            /* parameter is for symmetry with "rwalk" therefore unused*/
+            bq.reserve(this->steps + nh);
+        }
+
+        dis_bfs_frontier(Parent& parent, dis_bfs_frontier&& rhs)
+            : tab(parent), steps(rhs.steps), bq(std::move(rhs.bq))
+        { }
+
+        // t is moved into the table, it is unchanged if no path is found,
+        // returns the length of the path
+        inline std::pair<int, value_intern*>
+        insert(value_intern& t, hashed_type hash)
+        {
+            bucket_type* b[nh];
+
+            bq.clear();
+            tab.get_buckets(hash, b);
+
+            for (size_t i = 0; i < nh; ++i)
+            {
+                bq.push_back(bfs_item{nullptr, 0, -1, b[i], hash});
+            }
+
+            size_t level_begin = 0;
+            for (size_t depth = 1; level_begin < bq.size(); ++depth)
+            {
+                size_t level_end = bq.size();
+                expand(level_begin, level_end);
+
+                for (size_t i = level_end; i < bq.size(); ++i)
+                {
+                    if (bq[i].to->space())
+                    {
+                        value_intern* pos = rollBackDisplacements(i, t);
+                        return std::make_pair((pos) ? int(depth) : -1, pos);
+                    }
+                }
+                level_begin = level_end;
+            }
+
+            return std::make_pair(-1, nullptr);
+        }
+
+    private:
+        // appends (and prefetches) the buckets of all elements in the
+        // buckets of bq[begin, end), these buckets are full
+        inline void expand(size_t begin, size_t end)
+        {
+            hashed_type hashes[bs];
+            for (size_t index = begin; index < end; ++index)
+            {
+                if (bq.size() >= steps) return;
+
+                bucket_type* b = bq[index].to;
+                tab.slot_hashes(b, bs, hashes);
+
+                for (size_t i = 0; i < bs; ++i)
+                {
+                    if (bq.size() >= steps) return;
+
+                    const hashed_type& hash = hashes[i];
+
+                    bucket_type* ptr[nh];
+                    tab.get_buckets(hash, ptr);
+                    for (size_t ti = 0; ti < nh; ++ti)
+                    {
+                        if (ptr[ti] != b)
+                        {
+                            prefetch_lines(ptr[ti]);
+                            bq.push_back(bfs_item{b, i, int(index), ptr[ti], hash});
+                        }
+                    }
+                }
+            }
+        }
+
+        // elements are moved along the path ending in bq[last] (each slot
+        // is overwritten right after its element was moved)
+        inline value_intern* rollBackDisplacements(size_t last, value_intern& t)
+        {
+            bfs_item curr = bq[last];
+            curr.to->insert_ptr(std::move(curr.from->elements[curr.slot]), curr.hash);
+            tab.count_fill(curr.hash, curr.to, 1);
+
+            value_intern* pos = nullptr;
+            while (curr.prev >= 0)
+            {
+                const bfs_item& prev = bq[curr.prev];
+                value_intern& e = (prev.from) ? prev.from->elements[prev.slot] : t;
+                curr.from->replace(curr.slot, std::move(e), prev.hash);
+
+                pos  = &(curr.from->elements[curr.slot]);
+                curr = prev;
+            }
+
+            return pos;
+        }
+
+    };
+
+} // namespace cuckoo_displacement
+} // namespace dysect
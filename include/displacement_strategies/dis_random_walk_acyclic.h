@@ -3,7 +3,9 @@
 /*******************************************************************************
  * include/displacement_strategies/dis_walk_acyclic.h
  *
- * dis_random_walk_acyclic
+ * dis_random_walk_acyclic implements a random walk displacement
+ * technique, which removes cycles while precomputing the path.  The path
+ * is kept between insertions.
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -15,7 +17,9 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
-#include <random>
+#include <utility>
+
+#include "dis_rng.h"
 
 namespace dysect
 {
@@ -28,56 +32,56 @@ namespace cuckoo_displacement
     private:
         using key_type       = typename Parent::key_type;
         using mapped_type    = typename Parent::mapped_type;
-        using value_intern   = std::pair<key_type,mapped_type>;
+        using value_intern   = typename Parent::value_intern;
 
         using parent_type    = Parent;
         using hashed_type    = typename Parent::hashed_type;
         using bucket_type    = typename Parent::bucket_type;
 
         parent_type& tab;
-        std::mt19937 re;
+        dis_rng      re;
         const size_t steps;
+        std::vector<std::tuple<value_intern, hashed_type, bucket_type*> > queue;
 
         static constexpr size_t nh = Parent::nh;
 
     public:
         dis_random_walk_acyclic(parent_type& parent, size_t steps=256, size_t seed=30982391937209388ull)
             : tab(parent), re(seed), steps(steps)
-        { }
+        { queue.reserve(steps+1); }
 
         dis_random_walk_acyclic(parent_type& parent, dis_random_walk_acyclic&& rhs)
-            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps)
+            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps),
+              queue(std::move(rhs.queue))
         { }
 
-        inline std::pair<int, value_intern*> insert(std::pair<key_type,mapped_type> t, hashed_type hash)
+        inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
         {
 
-            std::vector<std::pair<value_intern, bucket_type*> > queue;
-            std::uniform_int_distribution<size_t> bin(0,nh-1);
-            std::uniform_int_distribution<size_t> bsd(0,tab.bs-1);
-            std::uniform_int_distribution<size_t> hfd(0,nh-2);
+            queue.clear();
 
             auto         tp = t;
-            bucket_type* tb = tab.get_bucket(hash, bin(re));
+            auto         hp = hash;
+            bucket_type* tb = tab.get_bucket(hash, re.bounded(nh));
 
-            queue.emplace_back(tp,tb);
+            queue.emplace_back(tp,hp,tb);
 
             size_t i = 0;
             for ( ; !(tb->space()) && i<steps; ++i)
             {
-                auto r = bsd(re);
+                auto r = re.bounded(tab.bs);
                 tp = tb->get(r);
-                auto hash = tab.hasher(tp.first);
-                auto tbd = tab.get_bucket(hash,hfd(re));
+                hp = tab.slot_hash(tb, r);
+                auto tbd = tab.get_bucket(hp,re.bounded(nh-1));
                 if (tbd != tb) tb = tbd;
-                else           tb = tab.get_bucket(hash, nh-1);
+                else           tb = tab.get_bucket(hp, nh-1);
 
-                queue.emplace_back(tp,tb);
+                queue.emplace_back(tp,hp,tb);
 
                 // Explicit Cycle Detection (they are popped from the displacement queue)
                 for (size_t j = 0; j < queue.size() - 1; ++j)
                 {
-                    if (queue[j].second == tb)
+                    if (std::get<2>(queue[j]) == tb)
                     {
                         while (queue.size() > j+1) queue.pop_back();
                         break;
@@ -89,14 +93,14 @@ namespace cuckoo_displacement
 
             for (size_t i = queue.size()-1; i > 0; --i)
             {
-                std::tie(tp,tb) = queue[i];
-                if (! queue[i-1].second->remove(tp.first) ||
-                    ! tb->insert(tp.first, tp.second))
+                std::tie(tp,hp,tb) = queue[i];
+                if (! std::get<2>(queue[i-1])->remove(tp.first, hp) ||
+                    ! tb->insert_ptr(tp, hp))
                 { return std::make_pair(-1, nullptr); }
 
             }
 
-            value_intern* pos = queue[0].second->insert_ptr(t);
+            value_intern* pos = std::get<2>(queue[0])->insert_ptr(std::move(t), hash);
 
             return std::make_pair((pos) ? i : -1, pos);
         }
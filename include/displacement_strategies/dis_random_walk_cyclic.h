@@ -6,7 +6,7 @@
  * dis_random_walk_cyclic implements a random walk displacement
  * technique, which precomputes the whole displacement path. It does
  * not remove possible cycles, instead cycles get handled during the
- * actual displacement.
+ * actual displacement.  The path is kept between insertions.
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -18,7 +18,8 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
-#include <random>
+
+#include "dis_rng.h"
 
 namespace dysect
 {
@@ -31,7 +32,7 @@ namespace cuckoo_displacement
     private:
         using key_type     = typename Parent::key_type;
         using mapped_type  = typename Parent::mapped_type;
-        using value_intern = std::pair<key_type, mapped_type>;
+        using value_intern = typename Parent::value_intern;
 
         using parent_type  = Parent;
         using hashed_type  = typename Parent::hashed_type;
@@ -40,59 +41,61 @@ namespace cuckoo_displacement
         static constexpr size_t nh = Parent::nh;
 
         parent_type& tab;
-        std::mt19937 re;
+        dis_rng      re;
         const size_t steps;
+        std::vector<std::tuple<value_intern, hashed_type, bucket_type*> > queue;
 
     public:
         dis_random_walk_cyclic(parent_type& parent, size_t steps=256, size_t seed=30982391937209388ull)
             : tab(parent), re(seed), steps(steps)
-        { }
+        { queue.reserve(steps+1); }
 
         dis_random_walk_cyclic(parent_type& parent, dis_random_walk_cyclic&& rhs)
-            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps)
+            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps),
+              queue(std::move(rhs.queue))
         { }
 
-        inline std::pair<int, value_intern*> insert(value_intern t, hashed_type hash)
+        inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
         {
-            std::vector<std::pair<value_intern, bucket_type*> > queue;
-            std::uniform_int_distribution<size_t> bin(0,nh-1);
-            std::uniform_int_distribution<size_t> bsd(0,tab.bs-1);
-            std::uniform_int_distribution<size_t> hfd(0,nh-2);
+            queue.clear();
 
             auto tp = t;
-            bucket_type*  tb  = tab.get_bucket(hash, bin(re));
+            auto hp = hash;
+            bucket_type*  tb  = tab.get_bucket(hash, re.bounded(nh));
             value_intern* pos = nullptr;
 
-            queue.emplace_back(tp,tb);
+            queue.emplace_back(tp,hp,tb);
             for (size_t i = 0; !tb->space() && i<steps; ++i)
             {
-                auto r = bsd(re);
+                auto r  = re.bounded(tab.bs);
+                auto hr = tab.slot_hash(tb, r);
                 if (tp.first == t.first) pos = &(tb->elements[r]);
-                tp = tb->replace(r, tp);
+                tp = tb->replace(r, tp, hp);
 
-                auto hash = tab.hasher(tp.first);
-                auto tbd  = tab.get_bucket(hash, hfd(re));
+                hp        = hr;
+                auto tbd  = tab.get_bucket(hp, re.bounded(nh-1));
                 if (tbd != tb) tb = tbd;
-                else           tb = tab.get_bucket(hash, nh-1);
+                else           tb = tab.get_bucket(hp, nh-1);
 
-                queue.emplace_back(tp,tb);
+                queue.emplace_back(tp,hp,tb);
             }
 
-            if (tb->insert(tp))
+            if (tb->insert_ptr(tp, hp))
             {
                 return std::make_pair(queue.size() -1, pos);
             }
 
-            std::pair<key_type,mapped_type> ttp;
-            std::tie(ttp, tb) = queue[queue.size() - 1];
+            value_intern ttp;
+            hashed_type                     tth;
+            std::tie(ttp, tth, tb) = queue[queue.size() - 1];
             for (size_t i = queue.size() - 2; i >= 1; --i)
             {
-                std::tie(tp, tb) = queue[i];
-                if (!(tb->remove(tp.first)))
+                std::tie(tp, hp, tb) = queue[i];
+                if (!(tb->remove(tp.first, hp)))
                 { std::cout << "f1" << std::endl; }
-                if (!(tb->insert(ttp.first, ttp.second)))
+                if (!(tb->insert_ptr(ttp, tth)))
                 { std::cout << "f2" << std::endl; };
-                ttp = tp;
+                ttp = tp; tth = hp;
             }
 
             return std::make_pair(-1, nullptr);
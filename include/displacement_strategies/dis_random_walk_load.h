@@ -0,0 +1,152 @@
+#pragma once
+
+/*******************************************************************************
+ * include/displacement_strategies/dis_random_walk_load.h
+ *
+ * dis_random_walk_load implements a load aware random walk.  Each
+ * homeless element moves into the bucket (other than the one it was
+ * displaced from) whose subtable has the lowest load, and the displaced
+ * element is the one (of two random slots) whose other buckets are in
+ * the emptier subtable.  Thus, elements are steered towards subtables
+ * that just grew (DySECT, see subtable_load in cuckoo_base, uses_fill
+ * enables the counters).  Ties are
+ * broken randomly, therefore, the walk is a plain random walk in tables
+ * without fill counters.  Visited slots are stored to undo unsuccessful
+ * walks.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <limits>
+#include <vector>
+#include <utility>
+
+#include "dis_rng.h"
+
+namespace dysect
+{
+namespace cuckoo_displacement
+{
+
+    template<class Parent>
+    class dis_random_walk_load
+    {
+    private:
+        using key_type     = typename Parent::key_type;
+        using mapped_type  = typename Parent::mapped_type;
+        using value_intern = typename Parent::value_intern;
+
+        using parent_type  = Parent;
+        using hashed_type  = typename Parent::hashed_type;
+        using bucket_type  = typename Parent::bucket_type;
+
+        static constexpr size_t nh = Parent::nh;
+
+        parent_type& tab;
+        dis_rng      re;
+        const size_t steps;
+        std::vector<std::pair<bucket_type*, size_t> > path;
+
+    public:
+        static constexpr bool uses_fill = true;
+
+        dis_random_walk_load(parent_type& parent, size_t steps=256,
+                             size_t seed=30982391937209388ull)
+            : tab(parent), re(seed), steps(steps)
+        { path.reserve(steps+1); }
+
+        dis_random_walk_load(parent_type& parent, dis_random_walk_load&& rhs)
+            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps),
+              path(std::move(rhs.path))
+        { }
+
+        // t is moved into the table, it is unchanged if the walk fails,
+        // returns the number of displaced elements
+        inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
+        {
+            const key_type k   = t.first;
+            bucket_type*   tb  = emptiest(hash, nullptr).first;
+            size_t         r   = victim(tb);
+            auto           hp  = tab.slot_hash(tb, r);
+            auto           tp  = tb->replace(r, std::move(t), hash);
+            value_intern*  pos = &(tb->elements[r]);
+            path.clear();
+            path.emplace_back(tb, r);
+
+            for (size_t i = 0; i < steps; ++i)
+            {
+                tb = emptiest(hp, tb).first;
+
+                // the walk can displace t again, then tp is t
+                if (tb->space())
+                {
+                    value_intern* np = tb->insert_ptr(std::move(tp), hp);
+                    tab.count_fill(hp, tb, 1);
+                    return std::make_pair(i+1, (np->first == k) ? np : pos);
+                }
+
+                r = victim(tb);
+                auto hr = tab.slot_hash(tb, r);
+                if (tp.first == k) pos = &(tb->elements[r]);
+                tp = tb->replace(r, std::move(tp), hp);
+                hp = hr;
+                path.emplace_back(tb, r);
+            }
+
+            // undo the displacements (in reverse order), until t is homeless
+            for (size_t i = path.size(); i-- > 0; )
+            {
+                tb = path[i].first;
+                r  = path[i].second;
+                auto hr = tab.slot_hash(tb, r);
+                tp = tb->replace(r, std::move(tp), hp);
+                hp = hr;
+            }
+            t = std::move(tp);
+
+            return std::make_pair(-1, nullptr);
+        }
+
+    private:
+        // bucket of h (other than prev) in the subtable with the lowest
+        // load (ties are broken randomly), and this load
+        inline std::pair<bucket_type*, double> emptiest(hashed_type h,
+                                                        const bucket_type* prev)
+        {
+            bucket_type* best = nullptr;
+            double       load = std::numeric_limits<double>::max();
+            size_t       o    = re.bounded(nh);
+            for (size_t j = 0; j < nh; ++j)
+            {
+                size_t       i = (o + j < nh) ? o + j : o + j - nh;
+                bucket_type* b = tab.get_bucket(h, i);
+                if (b == prev) continue;
+
+                double l = tab.subtable_load(h, i);
+                if (l < load) { load = l; best = b; }
+            }
+            // all buckets of h are prev
+            if (! best) return std::make_pair(const_cast<bucket_type*>(prev), load);
+            return std::make_pair(best, load);
+        }
+
+        // slot of the full bucket tb whose element has the emptier other
+        // bucket (of two random slots)
+        inline size_t victim(bucket_type* tb)
+        {
+            size_t r0 = re.bounded(tab.bs);
+            size_t r1 = re.bounded(tab.bs);
+            if (r0 == r1) return r0;
+
+            double l0 = emptiest(tab.slot_hash(tb, r0), tb).second;
+            double l1 = emptiest(tab.slot_hash(tb, r1), tb).second;
+            return (l1 < l0) ? r1 : r0;
+        }
+    };
+
+} // namespace cuckoo_displacement
+} // namespace dysect
@@ -0,0 +1,156 @@
+#pragma once
+
+/*******************************************************************************
+ * include/displacement_strategies/dis_random_walk_lookahead.h
+ *
+ * dis_random_walk_lookahead implements a random walk displacement
+ * technique with one step of lookahead.  Before an element of a full
+ * bucket is displaced, all elements of the bucket are checked for a free
+ * slot in one of their other buckets.  If there is one, this element
+ * moves there and the walk ends.  Otherwise, a random element is
+ * displaced (as in dis_random_walk_optimistic).  Elements are moved
+ * along the walk, the visited slots are stored to undo unsuccessful
+ * walks.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <vector>
+#include <utility>
+
+#include "dis_rng.h"
+
+namespace dysect
+{
+namespace cuckoo_displacement
+{
+
+    template<class Parent>
+    class dis_random_walk_lookahead
+    {
+    private:
+        using key_type     = typename Parent::key_type;
+        using mapped_type  = typename Parent::mapped_type;
+        using value_intern = typename Parent::value_intern;
+
+        using parent_type  = Parent;
+        using hashed_type  = typename Parent::hashed_type;
+        using bucket_type  = typename Parent::bucket_type;
+
+        static constexpr size_t nh = Parent::nh;
+
+        parent_type& tab;
+        dis_rng      re;
+        const size_t steps;
+        std::vector<std::pair<bucket_type*, size_t> > path;
+
+    public:
+        dis_random_walk_lookahead(parent_type& parent, size_t steps=256,
+                                  size_t seed=30982391937209388ull)
+            : tab(parent), re(seed), steps(steps)
+        { path.reserve(steps+1); }
+
+        dis_random_walk_lookahead(parent_type& parent, dis_random_walk_lookahead&& rhs)
+            : tab(parent), re(std::move(rhs.re)), steps(rhs.steps),
+              path(std::move(rhs.path))
+        { }
+
+        // t is moved into the table, it is unchanged if the walk fails,
+        // returns the number of displaced elements
+        inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
+        {
+            const key_type k = t.first;
+            bucket_type*   b[nh];
+            tab.get_buckets(hash, b);
+
+            value_intern* pos = nullptr;
+            for (size_t i = 0; i < nh; ++i)
+            {
+                if (lookahead(b[i], t, hash, k, pos)) return std::make_pair(1, pos);
+            }
+
+            bucket_type*  tb  = b[re.bounded(nh)];
+            auto          r   = re.bounded(tab.bs);
+            auto          hp  = tab.slot_hash(tb, r);
+            auto          tp  = tb->replace(r, std::move(t), hash);
+            pos = &(tb->elements[r]);
+            path.clear();
+            path.emplace_back(tb, r);
+
+            for (size_t i = 0; i < steps; ++i)
+            {
+                tb = other_bucket(hp, tb);
+
+                // the walk can displace t again, then tp is t
+                if (tb->space())
+                {
+                    value_intern* np = tb->insert_ptr(std::move(tp), hp);
+                    tab.count_fill(hp, tb, 1);
+                    return std::make_pair(i+1, (np->first == k) ? np : pos);
+                }
+
+                if (lookahead(tb, tp, hp, k, pos)) return std::make_pair(i+2, pos);
+
+                r = re.bounded(tab.bs);
+                auto hr = tab.slot_hash(tb, r);
+                if (tp.first == k) pos = &(tb->elements[r]);
+                tp = tb->replace(r, std::move(tp), hp);
+                hp = hr;
+                path.emplace_back(tb, r);
+            }
+
+            // undo the displacements (in reverse order), until t is homeless
+            for (size_t i = path.size(); i-- > 0; )
+            {
+                tb = path[i].first;
+                r  = path[i].second;
+                auto hr = tab.slot_hash(tb, r);
+                tp = tb->replace(r, std::move(tp), hp);
+                hp = hr;
+            }
+            t = std::move(tp);
+
+            return std::make_pair(-1, nullptr);
+        }
+
+    private:
+        // moves an element of the full bucket tb into a free slot of one of
+        // its other buckets, and e (with hash h) into its place, pos is set
+        // to the new slot of the element with key k (e or the moved element)
+        inline bool lookahead(bucket_type* tb, value_intern& e, hashed_type h,
+                              const key_type& k, value_intern*& pos)
+        {
+            for (size_t i = 0; i < tab.bs; ++i)
+            {
+                auto hi = tab.slot_hash(tb, i);
+                for (size_t j = 0; j < nh; ++j)
+                {
+                    bucket_type* target = tab.get_bucket(hi, j);
+                    if (target != tb && target->space())
+                    {
+                        value_intern* np = target->insert_ptr(std::move(tb->elements[i]), hi);
+                        tab.count_fill(hi, target, 1);
+                        tb->replace(i, std::move(e), h);
+                        if (np->first == k)                  pos = np;
+                        else if (tb->elements[i].first == k) pos = &(tb->elements[i]);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // random bucket of h, other than tb
+        inline bucket_type* other_bucket(hashed_type h, bucket_type* tb)
+        {
+            bucket_type* nb = tab.get_bucket(h, re.bounded(nh-1));
+            return (nb != tb) ? nb : tab.get_bucket(h, nh-1);
+        }
+    };
+
+} // namespace cuckoo_displacement
+} // namespace dysect
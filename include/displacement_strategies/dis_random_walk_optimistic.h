@@ -4,8 +4,13 @@
  * include/displacement_strategies/dis_random_walk_optimistic.h
  *
  * dis_random_walk_optimistic implements a random walk displacement
- * technique the displacement path is not stored, therefore, one
- * element will get lost during unsuccessful displacements.
+ * technique, elements are displaced while walking.  Only the visited
+ * slots are stored, to undo unsuccessful displacements.  Elements are
+ * moved (not copied) along the walk.  The path buffer is kept between
+ * insertions, random choices use dis_rng (no distribution objects).
+ * With primary_first (see cuckoo_config), the walk starts in the first
+ * bucket of the new element and displaced elements move back to their
+ * first bucket (to a random other bucket, if they are displaced from it).
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -17,7 +22,9 @@
 #include <iostream>
 #include <vector>
 #include <tuple>
-#include <random>
+#include <utility>
+
+#include "dis_rng.h"
 
 template<class Parent>
 class dis_random_walk_optimistic
@@ -25,56 +32,93 @@ class dis_random_walk_optimistic
 private:
     using key_type     = typename Parent::key_type;
     using mapped_type  = typename Parent::mapped_type;
-    using value_intern = std::pair<key_type, mapped_type>;
+    using value_intern = typename Parent::value_intern;
 
     using parent_type  = Parent;
     using hashed_type  = typename Parent::hashed_type;
     using bucket_type  = typename Parent::bucket_type;
 
     static constexpr size_t nh = Parent::nh;
+    static constexpr bool   primary_first = Parent::primary_first;
 
     parent_type&    tab;
-    std::mt19937 re;
+    dysect::cuckoo_displacement::dis_rng re;
     const size_t steps;
+    std::vector<std::pair<bucket_type*, size_t> > path;
 
 public:
     dis_random_walk_optimistic(parent_type& parent, size_t steps=256, size_t seed=30982391937209388ull)
         : tab(parent), re(seed), steps(steps)
-    { }
+    { path.reserve(steps+1); }
 
     dis_random_walk_optimistic(parent_type& parent, dis_random_walk_optimistic&& rhs)
-        : tab(parent), re(std::move(rhs.re)), steps(rhs.steps)
+        : tab(parent), re(std::move(rhs.re)), steps(rhs.steps),
+          path(std::move(rhs.path))
     { }
 
-    inline std::pair<int, value_intern*> insert(value_intern t, hashed_type hash)
+    // t is moved into the table, it is unchanged if the walk fails
+    inline std::pair<int, value_intern*> insert(value_intern& t, hashed_type hash)
     {
-        std::uniform_int_distribution<size_t> bin(0,nh-1);
-        std::uniform_int_distribution<size_t> bsd(0,tab.bs-1);
-        //std::uniform_int_distribution<size_t> hfd(0,nh-2);
-
-        auto          tp  = t;
-        bucket_type*  tb  = tab.get_bucket(hash, bin(re));
-        value_intern* pos = nullptr;
+        const key_type k   = t.first;
+        auto           hp  = hash;
+        bucket_type*   tb  = tab.get_bucket(hash, (primary_first) ? 0 : re.bounded(nh));
+        value_intern*  pos = nullptr;
 
-        auto r = bsd(re);
-        tp     = tb->replace(r, tp);
-        pos    = &(tb->elements[r]);
+        auto r  = re.bounded(tab.bs);
+        auto hr = tab.slot_hash(tb, r);
+        auto tp = tb->replace(r, std::move(t), hp);
+        hp      = hr;
+        pos     = &(tb->elements[r]);
+        path.clear();
+        path.emplace_back(tb, r);
 
         for (size_t i = 0; i<steps; ++i)
         {
-            auto hash = tab.hasher(tp.first);
-            //auto tbd  = tab.get_bucket(hash, hfd(re));
+            //auto tbd  = tab.get_bucket(hp, hfd(re));
             //if (tbd != tb) tb = tbd;
-            //else           tb = tab.get_bucket(hash, nh-1);
-            tb  = tab.get_bucket(hash, bin(re));
+            //else           tb = tab.get_bucket(hp, nh-1);
+            tb  = next_bucket(hp, tb);
 
-            if (tb->space()) { tb->insert(tp); return std::make_pair(i, pos); }
+            // the walk can displace t again, then tp is t
+            if (tb->space())
+            {
+                value_intern* np = tb->insert_ptr(std::move(tp), hp);
+                tab.count_fill(hp, tb, 1);
+                return std::make_pair(i, (np->first == k) ? np : pos);
+            }
 
-            r = bsd(re);
-            if (tp.first == t.first) pos = &(tb->elements[r]);
-            tp = tb->replace(r, tp);
+            r  = re.bounded(tab.bs);
+            hr = tab.slot_hash(tb, r);
+            if (tp.first == k) pos = &(tb->elements[r]);
+            tp = tb->replace(r, std::move(tp), hp);
+            hp = hr;
+            path.emplace_back(tb, r);
+        }
+
+        // undo the displacements (in reverse order), until t is homeless
+        for (size_t i = path.size(); i-- > 0; )
+        {
+            tb = path[i].first;
+            r  = path[i].second;
+            hr = tab.slot_hash(tb, r);
+            tp = tb->replace(r, std::move(tp), hp);
+            hp = hr;
         }
+        t = std::move(tp);
 
         return std::make_pair(-1, nullptr);
     }
+
+private:
+    // bucket of the element with hash h that was displaced from prev
+    inline bucket_type* next_bucket(hashed_type h, const bucket_type* prev)
+    {
+        if (primary_first)
+        {
+            bucket_type* pb = tab.get_bucket(h, 0);
+            if (pb != prev || nh == 1) return pb;
+            return tab.get_bucket(h, 1 + re.bounded(nh-1));
+        }
+        return tab.get_bucket(h, re.bounded(nh));
+    }
 };
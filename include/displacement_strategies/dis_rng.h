@@ -0,0 +1,46 @@
+#pragma once
+
+/*******************************************************************************
+ * include/displacement_strategies/dis_rng.h
+ *
+ * dis_rng is the random number generator of the random walk displacement
+ * strategies (wyrand, one multiplication per number).  bounded(n) maps a
+ * random number to [0,n) with a multiply-shift instead of a modulo or a
+ * distribution object (the bias is negligible for small n).
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dysect
+{
+namespace cuckoo_displacement
+{
+
+    class dis_rng
+    {
+    public:
+        explicit dis_rng(uint64_t seed = 0) : state(seed) { }
+
+        inline uint64_t operator()()
+        {
+            state += 0xa0761d6478bd642full;
+            __uint128_t t = __uint128_t(state) * (state ^ 0xe7037ed1a0b428dbull);
+            return uint64_t(t >> 64) ^ uint64_t(t);
+        }
+
+        inline size_t bounded(size_t n)
+        { return size_t((__uint128_t((*this)()) * n) >> 64); }
+
+    private:
+        uint64_t state;
+    };
+
+} // namespace cuckoo_displacement
+} // namespace dysect
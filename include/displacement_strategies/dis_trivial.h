@@ -28,7 +28,7 @@ namespace cuckoo_displacement
     private:
         using key_type      = typename Parent::key_type;
         using mapped_type   = typename Parent::mapped_type;
-        using value_intern  = std::pair<key_type,mapped_type>;
+        using value_intern  = typename Parent::value_intern;
 
         using hashed_type   = typename Parent::hashed_type;
 
@@ -36,7 +36,7 @@ namespace cuckoo_displacement
         dis_trivial(Parent&, size_t, size_t) {}
         dis_trivial(Parent&, dis_trivial&&) {}
 
-        inline std::pair<int, value_intern*> insert(value_intern, hashed_type)
+        inline std::pair<int, value_intern*> insert(value_intern&, hashed_type)
         {   return std::make_pair(-1, nullptr); }
     };
 
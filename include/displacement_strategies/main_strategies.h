@@ -2,7 +2,11 @@
 
 #include "dis_trivial.h"
 #include "dis_bfs1.h"
+#include "dis_bfs_frontier.h"
 #include "dis_random_walk_optimistic.h"
+#include "dis_random_walk_lookahead.h"
+#include "dis_random_walk_load.h"
+#include "dis_adaptive.h"
 
 namespace dysect
 {
@@ -11,7 +15,11 @@ namespace cuckoo_displacement
 
     template<class c> using trivial     = dis_trivial<c>;
     template<class c> using bfs         = dis_bfs1<c>;
+    template<class c> using bfs_frontier = dis_bfs_frontier<c>;
     template<class c> using random_walk = dis_random_walk_optimistic<c>;
+    template<class c> using lookahead   = dis_random_walk_lookahead<c>;
+    template<class c> using adaptive    = dis_adaptive<c>;
+    template<class c> using load_walk   = dis_random_walk_load<c>;
 
 } // namespace cuckoo_displacement
 } // namespace dysect
@@ -0,0 +1,69 @@
+#pragma once
+
+/*******************************************************************************
+ * include/element.h
+ *
+ * element_traits defines how the tables store their elements.  Usually
+ * an element is a std::pair<key_type, mapped_type>.  Tables with
+ * mapped_type void (set mode, e.g. cuckoo_dysect<K, void>) store only
+ * keys (set_element), this halves the size of each slot for 8 byte keys
+ * and data.  Iterators of such tables dereference to const key_type&.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <tuple>
+#include <utility>
+
+namespace dysect
+{
+
+    // key only element, it has the same layout as key_type (thus, the
+    // iterators can reinterpret it), and the member first, s.t. all
+    // tables can access the key in the same way
+    template<class K>
+    struct set_element
+    {
+        set_element() : first() { }
+        set_element(const K& k) : first(k) { }
+        set_element(K&& k) : first(std::move(k)) { }
+
+        K first;
+    };
+
+    // placeholder for the (non-existing) data in insert(k, d) on sets
+    struct no_mapped { };
+
+
+
+    template<class K, class D>
+    struct element_traits
+    {
+        using value_intern      = std::pair<K, D>;
+        using value_type        = std::pair<const K, D>;
+        using mapped_param_type = D;
+        using mapped_reference  = D&;
+        using const_mapped_reference = const D&;
+
+        static value_intern make(const K& k, const D& d)
+        { return value_intern(k, d); }
+    };
+
+    template<class K>
+    struct element_traits<K, void>
+    {
+        using value_intern      = set_element<K>;
+        using value_type        = const K;
+        using mapped_param_type = no_mapped;
+        using mapped_reference  = void;   // no at(k) or operator[] on sets
+        using const_mapped_reference = void;
+
+        static value_intern make(const K& k, const no_mapped&)
+        { return value_intern(k); }
+    };
+
+} // namespace dysect
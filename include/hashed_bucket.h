@@ -0,0 +1,127 @@
+#pragma once
+
+/*******************************************************************************
+ * include/hashed_bucket.h
+ *
+ * hashed_bucket extends a packed bucket type (bucket, tag_bucket) with the
+ * hashed value of each element. Growing (migration) and displacements can
+ * then find the other buckets of an element without evaluating the hash
+ * function again. This costs one hashed_type (usually 8 byte) per slot.
+ *
+ * Use it through cuckoo_config<..., true> (StoreHash).  slot_hash gives
+ * tables a uniform way to get the hash of a stored element, it recomputes
+ * the hash for buckets that do not store it.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstddef>
+#include <utility>
+
+namespace dysect
+{
+
+    template<class Bucket, class Hashed>
+    class hashed_bucket : public Bucket
+    {
+    private:
+        using base_type        = Bucket;
+    public:
+        using key_type         = typename base_type::key_type;
+        using mapped_type      = typename base_type::mapped_type;
+        using value_intern     = typename base_type::value_intern;
+        using hashed_type      = Hashed;
+        static constexpr size_t bs = base_type::bs;
+
+        hashed_bucket() : base_type()
+        {
+            for (size_t i = 0; i < bs; ++i)
+                hashes[i] = hashed_type();
+        }
+        hashed_bucket(const hashed_bucket& rhs) = default;
+        hashed_bucket& operator=(const hashed_bucket& rhs) = default;
+
+        using base_type::elements;
+        using base_type::find_ptr;
+        using base_type::probe_ptr;
+
+        value_intern* insert_ptr(value_intern t, const hashed_type& h)
+        {
+            auto ptr = base_type::insert_ptr(std::move(t), h);
+            if (ptr) hashes[ptr - elements] = h;
+            return ptr;
+        }
+
+        template<class LKey>
+        bool remove(const LKey& k, const hashed_type& h)
+        {
+            auto ptr = base_type::find_ptr(k, h);
+            if (! ptr) return false;
+
+            remove_at(ptr - elements);
+            return true;
+        }
+
+        // the bucket refills the hole with its last element
+        void remove_at(const size_t i)
+        {
+            size_t j = base_type::size() - 1;
+            base_type::remove_at(i);
+            hashes[i] = hashes[j];
+        }
+
+        value_intern replace(const size_t i, value_intern t,
+                             const hashed_type& h)
+        {
+            hashes[i] = h;
+            return base_type::replace(i, std::move(t), h);
+        }
+
+        const hashed_type& hash(const size_t i) const { return hashes[i]; }
+
+    private:
+        hashed_type hashes[bs];
+    };
+
+
+
+    // hash of the element in slot i of bucket b (computed with hasher h,
+    // if the bucket does not store it)
+    template<class Bucket>
+    struct slot_hash
+    {
+        template<class Hasher>
+        static inline auto get(const Bucket& b, size_t i, const Hasher& h)
+            -> decltype(h(b.elements[i].first))
+        { return h(b.elements[i].first); }
+
+        // hashes of the first n elements (all keys are hashed at once)
+        template<class Hasher, class Hashed>
+        static inline void get_n(const Bucket& b, size_t n, const Hasher& h,
+                                 Hashed* out)
+        {
+            typename Bucket::key_type keys[Bucket::bs];
+            for (size_t i = 0; i < n; ++i) keys[i] = b.elements[i].first;
+            h.hash_n(keys, n, out);
+        }
+    };
+
+    template<class Bucket, class Hashed>
+    struct slot_hash<hashed_bucket<Bucket, Hashed> >
+    {
+        template<class Hasher>
+        static inline const Hashed& get(const hashed_bucket<Bucket, Hashed>& b,
+                                        size_t i, const Hasher&)
+        { return b.hash(i); }
+
+        template<class Hasher>
+        static inline void get_n(const hashed_bucket<Bucket, Hashed>& b,
+                                 size_t n, const Hasher&, Hashed* out)
+        { for (size_t i = 0; i < n; ++i) out[i] = b.hash(i); }
+    };
+
+} // namespace dysect
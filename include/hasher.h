@@ -15,6 +15,11 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
 namespace dysect
 {
 
@@ -27,6 +32,37 @@ namespace dysect
     template <class Hashed, size_t tab_width, bool dpair, bool lcomb>
     class  hash_value_extractor;
 
+    // evaluates one hash function on n keys, uses HFct::hash_n if it exists
+    // (e.g. the AVX2 kernels in utils/hashfct.h)
+    template <class HFct, class Key, class Enable = void>
+    struct batch_hash
+    {
+        static inline void apply(const HFct& f, const Key* k, size_t n, uint64_t* out)
+        { for (size_t i = 0; i < n; ++i) out[i] = f(k[i]); }
+    };
+
+    template <class HFct, class Key>
+    struct batch_hash<HFct, Key,
+                      decltype(std::declval<const HFct&>().hash_n(
+                                   std::declval<const Key*>(), size_t(0),
+                                   std::declval<uint64_t*>()))>
+    {
+        static inline void apply(const HFct& f, const Key* k, size_t n, uint64_t* out)
+        { f.hash_n(k, n, out); }
+    };
+
+    // true if lookups with key type LKey are hashed by HFct directly (HFct
+    // defines is_transparent, e.g. std::string_view for std::string keys),
+    // LKey is only used to defer the evaluation
+    template <class HFct, class LKey, class Enable = void>
+    struct transparent_key : std::false_type { };
+
+    template <class HFct, class LKey>
+    struct transparent_key<HFct, LKey,
+                           typename std::conditional<true, void,
+                                                     typename HFct::is_transparent>::type>
+        : std::true_type { };
+
 
 
 
@@ -55,6 +91,14 @@ namespace dysect
         {
             uint64_t hash [n_hfct];
             splitter_type split[n_hfct];
+
+            // 8 bit fingerprint (never 0) e.g. used by tag_bucket, all bits
+            // are mixed in, since the low bits also determine the bucket
+            inline uint8_t tag() const
+            {
+                uint8_t t = (hash[0] * 0x9E3779B97F4A7C15ull) >> 56;
+                return t ? t : 1;
+            }
         };
 
         static_assert (sizeof(hashed_type) == n_hfct*8,
@@ -68,16 +112,56 @@ namespace dysect
 
     public:
 
-        hasher()
+        hasher(size_t seed = 0) { reseed(seed); }
+
+        // replaces all hash functions (used when rehashing a table)
+        void reseed(size_t seed)
         {
             for (size_t i = 0; i < n_hfct; ++i)
             {
                 fct[i] = hash_function_type(  2345745572344267838ull +
-                                            i*8768656543548765336ull);
+                                            i*8768656543548765336ull +
+                                         seed*11400714819323198485ull);
             }
         }
 
-        hashed_type operator()(Key k) const
+        template <class LKey>
+        using transparent = transparent_key<hash_function_type, LKey>;
+
+        hashed_type operator()(const Key& k) const { return eval(k); }
+
+        // heterogeneous lookup (only for transparent hash functions)
+        template <class LKey,
+                  class = typename std::enable_if<transparent<LKey>::value>::type>
+        hashed_type operator()(const LKey& k) const { return eval(k); }
+
+        // out[j] = (*this)(keys[j]) for j < n
+        void hash_n(const Key* keys, size_t n, hashed_type* out) const
+        {
+            using batch_type = batch_hash<hash_function_type, Key>;
+
+            if (n_hfct == 1)
+            {
+                batch_type::apply(fct[0], keys, n, reinterpret_cast<uint64_t*>(out));
+                return;
+            }
+
+            static constexpr size_t block = 32;
+            uint64_t temp[block];
+            for (size_t j = 0; j < n; j += block)
+            {
+                size_t m = std::min(block, n-j);
+                for (size_t i = 0; i < n_hfct; ++i)
+                {
+                    batch_type::apply(fct[i], keys+j, m, temp);
+                    for (size_t l = 0; l < m; ++l) out[j+l].hash[i] = temp[l];
+                }
+            }
+        }
+
+    private:
+        template <class LKey>
+        hashed_type eval(const LKey& k) const
         {
             hashed_type result;
             for (size_t i = 0; i < n_hfct; ++i)
@@ -6,6 +6,7 @@
  * iterator_base is a basic iterator implementation, that is
  * independent from the used table. Appart from the increment
  * operator, which uses a table specific increment function.
+ * Iterators of sets (mapped_type void) dereference to the key.
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -14,6 +15,8 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include "element.h"
+
 namespace dysect
 {
 
@@ -25,8 +28,8 @@ namespace dysect
 
         using key_type     = typename table_type::key_type;
         using mapped_type  = typename table_type::mapped_type;
-        using value_intern = std::pair<      key_type, mapped_type>;
-        using value_table  = std::pair<const key_type, mapped_type>;
+        using value_intern = typename element_traits<key_type, mapped_type>::value_intern;
+        using value_table  = typename element_traits<key_type, mapped_type>::value_type;
         using cval_intern  = typename std::conditional<is_const, const value_intern , value_intern >::type;
 
     public:
@@ -71,4 +74,35 @@ namespace dysect
         increment_type incr;
     };
 
+
+
+    // Helpers for tables storing arrays of buckets (used by iterator_incr).
+    // Buckets may contain additional data (i.e. tags), therefore, elements
+    // are not contiguous between buckets. All elements of a bucket are
+    // stored at its front.
+
+    template <class Pointer, class Bucket>
+    inline Pointer first_in_buckets(Bucket* b, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (b[i].occupied(0)) return reinterpret_cast<Pointer>(&b[i].elements[0]);
+        }
+        return nullptr;
+    }
+
+    template <class Pointer, class Bucket>
+    inline Pointer next_in_buckets(Bucket* b, size_t n, Pointer cur)
+    {
+        using value_intern = typename Bucket::value_intern;
+
+        size_t i = (reinterpret_cast<const char*>(cur)
+                    - reinterpret_cast<const char*>(b)) / sizeof(Bucket);
+        size_t j = reinterpret_cast<const value_intern*>(cur) - b[i].elements + 1;
+
+        if (j < Bucket::bs && b[i].occupied(j))
+            return reinterpret_cast<Pointer>(&b[i].elements[j]);
+        return first_in_buckets<Pointer>(b+i+1, n-i-1);
+    }
+
 }
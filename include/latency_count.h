@@ -0,0 +1,200 @@
+#pragma once
+
+/*******************************************************************************
+ * include/latency_count.h
+ *
+ * Latency instrumentation for cuckoo tables (see cuckoo_config).  With
+ * latency_count, every insert, find, erase, and grow is timed (rdtsc,
+ * steady_clock nanoseconds on other architectures) and recorded in a
+ * log-bucketed histogram (log_histogram).  Percentiles are exact up to
+ * the bucket width of 1/8 of a power of two.  Grow stalls are recorded
+ * separately, and also in the insert that triggers them.  Operations
+ * within other operations (e.g. reinsertions while growing, shrinking,
+ * or rehashing) are not recorded.  Batched operations (find_batch,
+ * insert_batch) are not timed per element.
+ *
+ * no_latency_count (default) does nothing, its scope is empty and
+ * optimized away.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace dysect
+{
+
+    enum class table_op : size_t { insert = 0, find = 1, erase = 2, grow = 3 };
+
+    // values below 8 have their own bucket, larger values are split into
+    // 8 buckets per power of two
+    class log_histogram
+    {
+    public:
+        static constexpr size_t sub_bits  = 3;
+        static constexpr size_t n_buckets = (64 - sub_bits + 1) << sub_bits;
+
+        log_histogram() : hist(new uint64_t[n_buckets]) { clear(); }
+
+        inline void add(uint64_t v)
+        {
+            ++hist[index(v)];
+            ++n;
+            vmax = std::max(vmax, v);
+        }
+
+        inline uint64_t count() const { return n; }
+        inline uint64_t max()   const { return vmax; }
+
+        // smallest bucket bound, s.t. a fraction q of all values is below
+        // it (q in [0,1], e.g. .999)
+        uint64_t percentile(double q) const
+        {
+            if (!n) return 0;
+            uint64_t rank = std::max<uint64_t>(1, uint64_t(q * double(n) + .5));
+            uint64_t sum  = 0;
+            for (size_t i = 0; i < n_buckets; ++i)
+            {
+                sum += hist[i];
+                if (sum >= rank) return std::min(upper(i), vmax);
+            }
+            return vmax;
+        }
+
+        void clear()
+        {
+            std::fill(hist.get(), hist.get()+n_buckets, 0);
+            n    = 0;
+            vmax = 0;
+        }
+
+    private:
+        std::unique_ptr<uint64_t[]> hist;
+        uint64_t n;
+        uint64_t vmax;
+
+        static inline size_t index(uint64_t v)
+        {
+            if (v < (1ull << sub_bits)) return v;
+            size_t msb = 63 - __builtin_clzll(v);
+            return ((msb - sub_bits + 1) << sub_bits)
+                   | ((v >> (msb - sub_bits)) & ((1ull << sub_bits) - 1));
+        }
+
+        // largest value of bucket i
+        static inline uint64_t upper(size_t i)
+        {
+            if (i < (1ull << sub_bits)) return i;
+            size_t   shift = (i >> sub_bits) - 1;
+            uint64_t lower = uint64_t((1ull << sub_bits) | (i & ((1ull << sub_bits) - 1)))
+                             << shift;
+            return lower + ((1ull << shift) - 1);
+        }
+    };
+
+    class latency_count
+    {
+    public:
+        using tick_type = uint64_t;
+
+        static inline tick_type now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        // records the time between its construction and its destruction
+        // (nested scopes only for table_op::grow)
+        class scope
+        {
+        public:
+            scope(latency_count& lc, table_op op)
+                : lc(lc), op(op),
+                  record(lc.depth++ == 0 || op == table_op::grow),
+                  start((record) ? now() : 0)
+            { }
+            ~scope()
+            {
+                --lc.depth;
+                if (record) lc.add(op, now() - start);
+            }
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+        private:
+            latency_count& lc;
+            table_op       op;
+            bool           record;
+            tick_type      start;
+        };
+
+        latency_count() : depth(0) { }
+
+        inline void add(table_op op, tick_type t) { hists[size_t(op)].add(t); }
+
+        inline const log_histogram& operator[](table_op op) const
+        { return hists[size_t(op)]; }
+
+        void clear() { for (auto& h : hists) h.clear(); }
+
+        static void print_header(std::ostream& out)
+        {
+            out.width(7);  out << "op";
+            out.width(10); out << "count";
+            out.width(10); out << "p50";
+            out.width(10); out << "p99";
+            out.width(10); out << "p999";
+            out.width(12); out << "max" << std::endl;
+        }
+
+        void print(std::ostream& out) const
+        {
+            static const char* names[] = { "insert", "find", "erase", "grow" };
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const auto& h = hists[i];
+                out.width(7);  out << names[i];
+                out.width(10); out << h.count();
+                out.width(10); out << h.percentile(.5);
+                out.width(10); out << h.percentile(.99);
+                out.width(10); out << h.percentile(.999);
+                out.width(12); out << h.max() << std::endl;
+            }
+        }
+
+    private:
+        log_histogram hists[4];
+        size_t        depth;
+    };
+
+    class no_latency_count
+    {
+    public:
+        class scope
+        {
+        public:
+            scope(const no_latency_count&, table_op) { }
+        };
+
+        inline void add(table_op, uint64_t) { }
+        void clear() { }
+        static void print_header(std::ostream&) { }
+        void print(std::ostream&) const { }
+    };
+
+} // namespace dysect
@@ -5,6 +5,12 @@
  *
  * prob_base is similar to cuckoo_base, in that it encapsules
  * everything, that all probing based hash tables have in common.
+ * Key 0 marks empty cells, an element with key 0 is kept in a separate
+ * slot of the table object.  With mapped_type void the table stores
+ * only keys (see element.h).  Elements are moved into the table
+ * (emplace, try_emplace), operator[] only constructs a value for new keys.
+ * Heterogeneous lookups work as in cuckoo_base (transparent hash function).
+ * stats() reports memory usage and the largest probe distance.
  *
  * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
  *
@@ -13,13 +19,18 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <vector>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "bucket.h"
+#include "hasher.h"
 #include "iterator_base.h"
+#include "table_stats.h"
 
 namespace dysect
 {
@@ -43,6 +54,10 @@ namespace dysect
         using specialized_type  = typename prob_traits<SpProb>::specialized_type;
         using hash_function_type      = typename prob_traits<SpProb>::hash_function_type;
 
+        template<class LKey>
+        using transparent_lookup = typename std::enable_if<
+                                       transparent_key<hash_function_type, LKey>::value>::type;
+
         friend specialized_type;
         friend iterator_incr<this_type>;
 
@@ -54,13 +69,16 @@ namespace dysect
         using const_iterator = iterator_base<iterator_incr<this_type>, true>;
 
     private:
-        using value_intern         = std::pair<key_type,mapped_type>;
+        using value_intern           = typename element_traits<key_type, mapped_type>::value_intern;
+        using mapped_param_type      = typename element_traits<key_type, mapped_type>::mapped_param_type;
+        using mapped_reference       = typename element_traits<key_type, mapped_type>::mapped_reference;
+        using const_mapped_reference = typename element_traits<key_type, mapped_type>::const_mapped_reference;
 
     public:
         prob_base(size_type cap, double alpha)
             : alpha(alpha), beta((alpha+1.)/2.), n(0),
               capacity((cap) ? cap*alpha : 2048*alpha),
-              thresh  ((cap) ? cap*beta  : 2048*beta)
+              thresh  ((cap) ? cap*beta  : 2048*beta), zero_used(false)
         {
             if (cap) table = std::make_unique<value_intern[]>(capacity);
         }
@@ -84,40 +102,75 @@ namespace dysect
 
         std::unique_ptr<value_intern[]> table;
 
+        // the element with key 0 (key 0 marks empty cells), it is not
+        // counted in n, iterators visit it after the table
+        bool         zero_used;
+        value_intern zero_elem;
+
     public:
         // Basic Hash Table Functionality ******************************************
         iterator                  find  (const key_type& k);
         const_iterator            find  (const key_type& k) const;
-        std::pair<iterator, bool> insert(const key_type& k, const mapped_type& d);
+        std::pair<iterator, bool> insert(const key_type& k, const mapped_param_type& d);
         std::pair<iterator, bool> insert(const value_intern& t);
+        std::pair<iterator, bool> insert(value_intern&& t);
         size_type                    erase (const key_type& k);
 
+        // see cuckoo_base (try_emplace and insert_or_assign only for maps)
+        template<class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args);
+        template<class... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args);
+        template<class M>
+        std::pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj);
+        template<class F>
+        std::pair<iterator, bool> upsert(const key_type& k, const mapped_param_type& init, F fn);
+        std::pair<iterator, bool> fetch_add(const key_type& k, const mapped_param_type& d);
+
         // Easy use Accessors for std compliance ***********************************
         inline iterator           begin ()
         {
             auto temp = make_iterator(&table[0]);
-            if (!temp->first) temp++;
+            if (!table[0].first) temp++;
             return temp;
         }
         inline const_iterator     begin()  const
         {
-            return static_cast<specialized_type*>(this)->cbegin();
+            return static_cast<const specialized_type*>(this)->cbegin();
         }
         inline const_iterator     cbegin() const
         {
             auto temp = make_citerator(&table[0]);
-            if (!temp->first) temp++;
+            if (!table[0].first) temp++;
             return temp;
         }
         inline iterator           end   () { return make_iterator(nullptr);  }
-        inline const_iterator     end   () const { return static_cast<specialized_type*>(this)->cend(); }
+        inline const_iterator     end   () const { return static_cast<const specialized_type*>(this)->cend(); }
         inline const_iterator     cend  () const { return make_citerator(nullptr); }
 
-        mapped_type&              at    (const key_type& k);
-        const mapped_type&        at    (const key_type& k) const;
-        mapped_type&              operator[](const key_type& k);
+        // only for maps (mapped_type not void)
+        mapped_reference          at    (const key_type& k);
+        const_mapped_reference    at    (const key_type& k) const;
+        mapped_reference          operator[](const key_type& k);
         size_type                 count (const key_type& k) const;
 
+        // Heterogeneous lookup (only with a transparent hash function) ************
+        template<class LKey, class = transparent_lookup<LKey> >
+        iterator                  find  (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        const_iterator            find  (const LKey& k) const;
+        template<class LKey, class = transparent_lookup<LKey> >
+        size_type                 erase (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        mapped_reference          at    (const LKey& k);
+        template<class LKey, class = transparent_lookup<LKey> >
+        const_mapped_reference    at    (const LKey& k) const;
+        template<class LKey, class = transparent_lookup<LKey> >
+        size_type                 count (const LKey& k) const;
+
+        // Memory and probe distances (see table_stats.h) **************************
+        table_stats stats() const;
+
     private:
         // Easy iterators **********************************************************
         inline iterator make_iterator(value_intern* pair) const
@@ -126,13 +179,45 @@ namespace dysect
         { return const_iterator(pair, *this); }
 
         // implementation specific functions (static polymorph) ********************
-        inline size_type h(key_type k) const
+        template<class LKey>
+        inline size_type h(const LKey& k) const
         { return static_cast<const specialized_type*>(this)->index(hasher(k)); }
 
-        inline void inc_n()
-        { if (++n > thresh) static_cast<specialized_type*>(this)->grow(); }
+        // lookup and removal (linear probing), tables with other probing
+        // schemes replace them (static polymorph)
+        template<class LKey>
+        value_intern* find_ptr (const LKey& k) const;
+        template<class LKey>
+        size_type     erase_key(const LKey& k);
+        // one pass insertion (replaced like find_ptr), returns the position
+        // of k if it is contained, otherwise the element make() is inserted
+        // (make is only called for new keys)
+        template<class Make>
+        std::pair<iterator, bool> insert_with(const key_type& k, Make make);
+
+        // same as above, but key 0 is looked up in its slot
+        template<class LKey>
+        value_intern* find_any (const LKey& k) const;
+        template<class LKey>
+        size_type     erase_any(const LKey& k);
+        template<class Make>
+        std::pair<iterator, bool> insert_zero(Make make);
+        inline value_intern* zero_ptr() const
+        { return (zero_used) ? const_cast<value_intern*>(&zero_elem) : nullptr; }
+
+        // tables grow before an insertion (like cuckoo_base), thus, the
+        // position of the new element stays valid
+        inline void grow_if_full()
+        { if (n >= thresh) grow_table(); }
+        inline void inc_n() { ++n; }
+        // growing replaces the table object (move assignment), the
+        // element with key 0 stays
+        void grow_table();
         inline void dec_n() { --n; }
 
+        // computes max_probe, tables add their additional memory (static polymorph)
+        void add_stats(table_stats& s) const;
+
         // Private helper function *************************************************
         void propagate_remove(size_type origin);
 
@@ -151,72 +236,59 @@ namespace dysect
     inline typename prob_base<SpProb>::iterator
     prob_base<SpProb>::find(const key_type& k)
     {
-        auto ind = h(k);
-
-        for (size_type i = ind; ; ++i)
-        {
-            size_type ti = static_cast<specialized_type*>(this)->mod(i);
-            auto temp = table[ti];
-
-            if ( temp.first == 0 )
-            {
-                break;
-            }
-            else if ( temp.first == k )
-            {
-                return make_iterator(&table[ti]);
-            }
-        }
-        return end();
+        value_intern* tp = find_any(k);
+        return (tp) ? make_iterator(tp) : end();
     }
 
     template<class SpProb>
     inline typename prob_base<SpProb>::const_iterator
     prob_base<SpProb>::find(const key_type& k) const
     {
-        auto ind = h(k);
-
-        for (size_type i = ind; ; ++i)
-        {
-            size_type ti = static_cast<const specialized_type*>(this)->mod(i);
-            auto temp = table[ti];
-
-            if ( temp.first == 0 )
-            {
-                break;
-            }
-            else if ( temp.first == k )
-            {
-                return make_citerator(&table[ti]);
-            }
-        }
-        return cend();
+        value_intern* tp = find_any(k);
+        return (tp) ? make_citerator(tp) : cend();
     }
 
     template<class SpProb>
     inline std::pair<typename prob_base<SpProb>::iterator, bool>
-    prob_base<SpProb>::insert(const key_type& k, const mapped_type& d)
+    prob_base<SpProb>::insert(const key_type& k, const mapped_param_type& d)
     {
-        return insert(std::make_pair(k,d));
+        return insert(element_traits<key_type, mapped_type>::make(k,d));
     }
 
     template<class SpProb>
     inline std::pair<typename prob_base<SpProb>::iterator, bool>
     prob_base<SpProb>::insert(const value_intern& t)
     {
-        auto ind = h(t.first);
+        return insert(value_intern(t));
+    }
+
+    template<class SpProb>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::insert(value_intern&& t)
+    {
+        return static_cast<specialized_type*>(this)->insert_with(
+            t.first, [&t]() -> value_intern&& { return std::move(t); });
+    }
+
+    template<class SpProb> template<class Make>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::insert_with(const key_type& k, Make make)
+    {
+        if (k == 0) return insert_zero(make);
+        static_cast<SpProb*>(this)->grow_if_full();
+        auto ind = h(k);
 
         for (size_type i = ind; ; ++i)
         {
             size_type ti = static_cast<specialized_type*>(this)->mod(i);
-            auto temp = table[ti];
-            if ( temp.first == t.first)
+            const auto& temp = table[ti];
+            if ( temp.first == k)
             {
                 return std::make_pair(make_iterator(&table[ti]), false);
             }
             if ( temp.first == 0 )
             {
-                table[ti] = t;
+                table[ti] = make();
                 //hcounter.add(i - ind);
                 static_cast<SpProb*>(this)->inc_n();
                 return std::make_pair(make_iterator(&table[ti]), true);
@@ -225,16 +297,92 @@ namespace dysect
         return std::make_pair(end(), false);
     }
 
+    template<class SpProb> template<class... Args>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::emplace(Args&&... args)
+    {
+        return static_cast<specialized_type*>(this)->insert(
+            value_intern(std::forward<Args>(args)...));
+    }
+
+    template<class SpProb> template<class... Args>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::try_emplace(const key_type& k, Args&&... args)
+    {
+        return static_cast<specialized_type*>(this)->insert_with(k, [&]()
+            { return value_intern(std::piecewise_construct, std::forward_as_tuple(k),
+                                  std::forward_as_tuple(std::forward<Args>(args)...)); });
+    }
+
+    template<class SpProb> template<class M>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::insert_or_assign(const key_type& k, M&& obj)
+    {
+        // obj is either moved into the new element or assigned
+        auto r = static_cast<specialized_type*>(this)->insert_with(k, [&]()
+            { return value_intern(k, std::forward<M>(obj)); });
+        if (! r.second && r.first != end()) (*r.first).second = std::forward<M>(obj);
+        return r;
+    }
+
+    // insert stops at the position of an existing key, therefore, the
+    // update needs no second lookup
+    template<class SpProb> template<class F>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::upsert(const key_type& k, const mapped_param_type& init, F fn)
+    {
+        auto r = static_cast<specialized_type*>(this)->insert(k, init);
+        if (! r.second && r.first != end()) fn((*r.first).second);
+        return r;
+    }
+
+    template<class SpProb>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::fetch_add(const key_type& k, const mapped_param_type& d)
+    {
+        return upsert(k, d, [&d](mapped_type& v) { v += d; });
+    }
+
     template<class SpProb>
     inline typename prob_base<SpProb>::size_type
     prob_base<SpProb>::erase(const key_type& k)
+    {
+        return erase_any(k);
+    }
+
+    template<class SpProb> template<class LKey>
+    inline typename prob_base<SpProb>::value_intern*
+    prob_base<SpProb>::find_ptr(const LKey& k) const
+    {
+        auto ind = h(k);
+
+        for (size_type i = ind; ; ++i)
+        {
+            size_type ti = static_cast<const specialized_type*>(this)->mod(i);
+            const auto& temp = table[ti];
+
+            if ( temp.first == 0 )
+            {
+                break;
+            }
+            else if ( temp.first == k )
+            {
+                return &table[ti];
+            }
+        }
+        return nullptr;
+    }
+
+    template<class SpProb> template<class LKey>
+    inline typename prob_base<SpProb>::size_type
+    prob_base<SpProb>::erase_key(const LKey& k)
     {
         auto ind = h(k);
 
         for (size_type i = ind; ; ++i)
         {
             size_type ti = static_cast<specialized_type*>(this)->mod(i);
-            auto temp = table[ti];
+            const auto& temp = table[ti];
 
             if ( temp.first == 0 )
             {
@@ -243,7 +391,7 @@ namespace dysect
             else if ( temp.first == k )
             {
                 dec_n();
-                table[ti] = std::make_pair(0,0);
+                table[ti] = value_intern();
                 static_cast<SpProb*>(this)->propagate_remove(ti);
                 return 1;
             }
@@ -252,11 +400,54 @@ namespace dysect
     }
 
 
+    template<class SpProb> template<class LKey>
+    inline typename prob_base<SpProb>::value_intern*
+    prob_base<SpProb>::find_any(const LKey& k) const
+    {
+        if (k == 0) return zero_ptr();
+        return static_cast<const specialized_type*>(this)->find_ptr(k);
+    }
+
+    template<class SpProb> template<class LKey>
+    inline typename prob_base<SpProb>::size_type
+    prob_base<SpProb>::erase_any(const LKey& k)
+    {
+        if (k == 0)
+        {
+            if (! zero_used) return 0;
+            zero_used = false;
+            zero_elem = value_intern();
+            return 1;
+        }
+        return static_cast<specialized_type*>(this)->erase_key(k);
+    }
+
+    template<class SpProb> template<class Make>
+    inline std::pair<typename prob_base<SpProb>::iterator, bool>
+    prob_base<SpProb>::insert_zero(Make make)
+    {
+        if (zero_used) return std::make_pair(make_iterator(&zero_elem), false);
+        zero_elem = make();
+        zero_used = true;
+        return std::make_pair(make_iterator(&zero_elem), true);
+    }
+
+    template<class SpProb>
+    inline void prob_base<SpProb>::grow_table()
+    {
+        bool         zu = zero_used;
+        value_intern ze = std::move(zero_elem);
+        static_cast<specialized_type*>(this)->grow();
+        zero_used = zu;
+        zero_elem = std::move(ze);
+    }
+
+
 
 // Accessor Implementations ****************************************************
 
     template<class SpProb>
-    inline typename prob_base<SpProb>::mapped_type&
+    inline typename prob_base<SpProb>::mapped_reference
     prob_base<SpProb>::at(const key_type& k)
     {
         auto a = static_cast<specialized_type*>(this)->find(k);
@@ -265,7 +456,7 @@ namespace dysect
     }
 
     template<class SpProb>
-    inline const typename prob_base<SpProb>::mapped_type&
+    inline typename prob_base<SpProb>::const_mapped_reference
     prob_base<SpProb>::at(const key_type& k) const
     {
         auto a = static_cast<const specialized_type*>(this)->find(k);
@@ -274,10 +465,10 @@ namespace dysect
     }
 
     template<class SpProb>
-    inline typename prob_base<SpProb>::mapped_type&
+    inline typename prob_base<SpProb>::mapped_reference
     prob_base<SpProb>::operator[](const key_type& k)
     {
-        auto t = static_cast<specialized_type*>(this)->insert(k, mapped_type());
+        auto t = static_cast<specialized_type*>(this)->try_emplace(k);
         return (*t.first).second;
     }
 
@@ -290,6 +481,89 @@ namespace dysect
 
 
 
+// Heterogeneous lookup ********************************************************
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::iterator
+    prob_base<SpProb>::find(const LKey& k)
+    {
+        value_intern* tp = find_any(k);
+        return (tp) ? make_iterator(tp) : end();
+    }
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::const_iterator
+    prob_base<SpProb>::find(const LKey& k) const
+    {
+        value_intern* tp = find_any(k);
+        return (tp) ? make_citerator(tp) : cend();
+    }
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::size_type
+    prob_base<SpProb>::erase(const LKey& k)
+    {
+        return erase_any(k);
+    }
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::mapped_reference
+    prob_base<SpProb>::at(const LKey& k)
+    {
+        auto a = static_cast<specialized_type*>(this)->find(k);
+        if (a == end()) throw std::out_of_range("cannot find key");
+        else return (*a).second;
+    }
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::const_mapped_reference
+    prob_base<SpProb>::at(const LKey& k) const
+    {
+        auto a = static_cast<const specialized_type*>(this)->find(k);
+        if (a == cend()) throw std::out_of_range("cannot find key");
+        else return (*a).second;
+    }
+
+    template<class SpProb> template<class LKey, class>
+    inline typename prob_base<SpProb>::size_type
+    prob_base<SpProb>::count(const LKey& k) const
+    {
+        return (static_cast<const specialized_type*>(this)->find(k) != cend()) ? 1 : 0;
+    }
+
+
+
+
+// Memory and probe distances **************************************************
+
+    template<class SpProb>
+    inline table_stats prob_base<SpProb>::stats() const
+    {
+        table_stats s;
+        s.elements        = n + zero_used;
+        s.capacity        = capacity;
+        s.element_bytes   = sizeof(value_intern);
+        s.bytes_allocated = sizeof(specialized_type) + capacity*sizeof(value_intern);
+
+        static_cast<const specialized_type*>(this)->add_stats(s);
+        s.bytes_reserved  = std::max(s.bytes_reserved, s.bytes_allocated);
+        return s;
+    }
+
+    template<class SpProb>
+    inline void prob_base<SpProb>::add_stats(table_stats& s) const
+    {
+        for (size_type i = 0; i < capacity; ++i)
+        {
+            if (! table[i].first) continue;
+            size_type ind  = h(table[i].first);
+            size_type dist = (i >= ind) ? i - ind : i + capacity - ind;
+            s.max_probe    = std::max(s.max_probe, dist);
+        }
+    }
+
+
+
 // Private Help Function *******************************************************
 
     template<class SpProb>
@@ -300,12 +574,11 @@ namespace dysect
         for (size_type i = origin+1; ; ++i)
         {
             size_type ti = static_cast<const SpProb*>(this)->mod(i);
-            auto temp = table[ti];
-
-            if (temp.first == 0) break;
+            if (table[ti].first == 0) break;
 
-            table[ti] = std::make_pair(0,0);
-            insert(temp);
+            auto temp = std::move(table[ti]);
+            table[ti] = value_intern();
+            insert(std::move(temp));
         }
         n = tempn;
     }
@@ -321,29 +594,33 @@ namespace dysect
         using table_type  = prob_base<Specialized>;
 
     private:
-        using key_type    = typename table_type::key_type;
-        using mapped_type = typename table_type::mapped_type;
-        using ipointer    = std::pair<const key_type, mapped_type>*;
+        using key_type     = typename table_type::key_type;
+        using mapped_type  = typename table_type::mapped_type;
+        using value_intern = typename table_type::value_intern;
+        using ipointer     = typename element_traits<key_type, mapped_type>::value_type*;
 
     public:
         iterator_incr(const table_type& table_)
             : end_ptr(reinterpret_cast<ipointer>
-                      (&table_.table[table_.capacity - 1]))
+                      (&table_.table[table_.capacity - 1])),
+              zero_ptr(reinterpret_cast<ipointer>(table_.zero_ptr()))
         { }
         iterator_incr(const iterator_incr&) = default;
         iterator_incr& operator=(const iterator_incr&) = default;
 
         ipointer next(ipointer cur)
         {
+            if (cur == zero_ptr) return nullptr;
             while (cur < end_ptr)
             {
-                if ((++cur)->first) return cur;
+                if (reinterpret_cast<const value_intern*>(++cur)->first) return cur;
             }
-            return nullptr;
+            return zero_ptr;
         }
 
     private:
         const ipointer end_ptr;
+        const ipointer zero_ptr;
     };
 
 }
@@ -136,7 +136,11 @@ namespace dysect
         using mapped_type    = typename prob_traits<this_type>::mapped_type;
         using iterator       = typename base_type::iterator;
         using const_iterator = typename base_type::const_iterator;
+    private:
+        using value_intern   = typename base_type::value_intern;
+        using mapped_param_type = typename base_type::mapped_param_type;
 
+    public:
         prob_hopscotch(size_t cap = 0      , double size_constraint = 1.1,
                  size_t /*dis_steps*/ = 0, size_t /*seed*/ = 0)
             : base_type(cap, size_constraint), nh_data(capacity-nh_size+1, capacity-nh_size+1)
@@ -166,17 +170,14 @@ namespace dysect
         using base_type::make_iterator;
         using base_type::make_citerator;
 
-    public:
-        //specialized functions because of Hops Hashing
-        inline std::pair<iterator, bool> insert(const key_type& k, const mapped_type& d)
-        {
-            return insert(std::make_pair(k,d));
-        }
-
-        inline std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type>& t)
+        //specialized insert because of Hops Hashing (see prob_base)
+        template<class Make>
+        inline std::pair<iterator, bool> insert_with(const key_type& k, Make make)
         {
-            // we first have to check if t.first is already present
-            size_t ind  = h(t.first);
+            if (k == 0) return base_type::insert_zero(make);
+            base_type::grow_if_full();
+            // we first have to check if k is already present
+            size_t ind  = h(k);
             auto   aug  = nh_data.get_accessor(ind);
             size_t bits = aug.get_neighborhood();
 
@@ -185,8 +186,8 @@ namespace dysect
                 if (!(bits & 1)) continue;
                 else
                 {
-                    auto temp = table[i];
-                    if ( temp.first == t.first )
+                    const auto& temp = table[i];
+                    if ( temp.first == k )
                     {
                         return std::make_pair(make_iterator(&table[i]), false);
                     }
@@ -195,7 +196,7 @@ namespace dysect
 
             for (size_t i = ind; ; ++i)
             {
-                auto temp  = table[i];
+                const auto& temp = table[i];
                 if ( temp.first == 0)
                 {
                     size_t ti = i;
@@ -205,7 +206,7 @@ namespace dysect
                         std::tie(successful, ti) = move_gap(i, ind+nh_size);
                         if (!successful) break;
                     }
-                    table[ti] = t;
+                    table[ti] = make();
                     aug.set(ti-ind);
                     inc_n();
                     return std::make_pair(make_iterator(&table[ti]), true);
@@ -214,24 +215,9 @@ namespace dysect
             return std::make_pair(base_type::end(), false);
         }
 
-        inline iterator find(const key_type& k)
-        {
-            auto ind = h(k);
-            size_t bits = nh_data.get_neighborhood(ind);
-
-            for (size_t i = ind; bits; ++i, bits>>=1)
-            {
-                if (!(bits & 1)) continue;
-                auto temp = table[i];
-                if ( temp.first == k )
-                {
-                    return make_iterator(&table[i]);
-                }
-            }
-            return base_type::end();
-        }
-
-        inline const_iterator find(const key_type& k) const
+        // used by find and erase (see prob_base)
+        template<class LKey>
+        inline value_intern* find_ptr(const LKey& k) const
         {
             auto ind = h(k);
             size_t bits = nh_data.get_neighborhood(ind);
@@ -239,16 +225,17 @@ namespace dysect
             for (size_t i = ind; bits; ++i, bits>>=1)
             {
                 if (!(bits & 1)) continue;
-                auto temp = table[i];
+                const auto& temp = table[i];
                 if ( temp.first == k )
                 {
-                    return make_citerator(&table[i]);
+                    return &table[i];
                 }
             }
-            return base_type::cend();
+            return nullptr;
         }
 
-        inline size_t erase(const key_type& k)
+        template<class LKey>
+        inline size_t erase_key(const LKey& k)
         {
             auto ind = h(k);
             size_t bits = nh_data.get_neighborhood(ind);
@@ -256,18 +243,24 @@ namespace dysect
             for (size_t i = ind; bits; ++i, bits>>=1)
             {
                 if (!(bits&1)) continue;
-                auto tempk = table[i].first;
+                const auto& tempk = table[i].first;
                 if ( tempk == k )
                 {
                     nh_data.get_accessor(ind).unset(i-ind);
-                    table[i] = std::make_pair(0,0);
+                    table[i] = value_intern();
                     return 1;
                 }
             }
             return 0;
         }
 
-    private:
+        // neighborhood bitsets are stored next to the table
+        inline void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_allocated += capacity*AugData_t::n_bytes;
+        }
+
         inline size_t index(size_t i) const
         { return double(bitmask & i) * factor; }
         inline size_t mod  (size_t i) const
@@ -279,9 +272,9 @@ namespace dysect
 
             for (size_t i = 0; i < capacity; ++i)
             {
-                auto current  = table[i];
+                auto& current = table[i];
                 if (current.first)
-                    ntable.insert(current);
+                    ntable.insert(std::move(current));
             }
 
             (*this) = std::move(ntable);
@@ -300,7 +293,7 @@ namespace dysect
                     aug.set  (pos-ind);
 
                     table[pos] = current;
-                    table[i]   = std::make_pair(0,0);
+                    table[i]   = value_intern();
                     if (i < goal) return std::make_pair(true, i);
                     else return move_gap(i, goal);
                 }
@@ -372,6 +365,7 @@ namespace dysect
         using const_iterator = typename base_type::const_iterator;
     private:
         using value_intern   = typename base_type::value_intern;
+        using mapped_param_type = typename base_type::mapped_param_type;
 
         static constexpr size_t max_size = 1ull << 30;
 
@@ -417,17 +411,14 @@ namespace dysect
         using base_type::make_iterator;
         using base_type::make_citerator;
 
-    public:
-        //specialized functions because of Hops Hashing
-        inline std::pair<iterator, bool> insert(const key_type& k, const mapped_type& d)
-        {
-            return insert(std::make_pair(k,d));
-        }
-
-        inline std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type>& t)
+        //specialized insert because of Hops Hashing (see prob_base)
+        template<class Make>
+        inline std::pair<iterator, bool> insert_with(const key_type& k, Make make)
         {
-            // we first have to check if t.first is already present
-            size_t ind  = h(t.first);
+            if (k == 0) return base_type::insert_zero(make);
+            base_type::grow_if_full();
+            // we first have to check if k is already present
+            size_t ind  = h(k);
             auto   aug  = nh_data.get_accessor(ind);
             size_t bits = aug.get_neighborhood();
 
@@ -438,10 +429,10 @@ namespace dysect
                 {
                     for (size_t ti = 0; ti<bucket_size; ++ti)
                     {
-                        auto temp = table[i+ti];
-                        if ( temp.first == t.first )
+                        const auto& temp = table[i+ti];
+                        if ( temp.first == k )
                         {
-                            return std::make_pair(make_iterator(&table[i]), false);
+                            return std::make_pair(make_iterator(&table[i+ti]), false);
                         }
                     }
                 }
@@ -449,7 +440,7 @@ namespace dysect
 
             for (size_t i = ind; ; ++i)
             {
-                auto temp  = table[i];
+                const auto& temp = table[i];
                 if ( temp.first == 0)
                 {
                     size_t ti = i;
@@ -459,7 +450,7 @@ namespace dysect
                         std::tie(successful, ti) = move_gap(i, ind+nh_size);
                         if (!successful) break;
                     }
-                    table[ti] = t;
+                    table[ti] = make();
                     aug.set((ti-ind)/bucket_size);
                     inc_n();
                     return std::make_pair(make_iterator(&table[ti]), true);
@@ -468,7 +459,9 @@ namespace dysect
             return std::make_pair(base_type::end(), false);
         }
 
-        inline iterator find(const key_type& k)
+        // used by find and erase (see prob_base)
+        template<class LKey>
+        inline value_intern* find_ptr(const LKey& k) const
         {
             auto ind = h(k);
             size_t bits = nh_data.get_neighborhood(ind);
@@ -478,37 +471,18 @@ namespace dysect
                 if (!(bits & 1)) continue;
                 for (size_t ti = 0; ti < bucket_size; ++ti)
                 {
-                    auto temp = table[i+ti];
+                    const auto& temp = table[i+ti];
                     if ( temp.first == k )
                     {
-                        return make_iterator(&table[i+ti]);
+                        return &table[i+ti];
                     }
                 }
             }
-            return base_type::end();
+            return nullptr;
         }
 
-        inline const_iterator find(const key_type& k) const
-        {
-            auto ind = h(k);
-            size_t bits = nh_data.get_neighborhood(ind);
-
-            for (size_t i = ind; bits; i+=bucket_size, bits>>=1)
-            {
-                if (!(bits & 1)) continue;
-                for (size_t ti = 0; ti < bucket_size; ++ti)
-                {
-                    auto temp = table[i+ti];
-                    if ( temp.first == k )
-                    {
-                        return make_citerator(&table[i+ti]);
-                    }
-                }
-            }
-            return base_type::cend();
-        }
-
-        inline size_t erase(const key_type& k)
+        template<class LKey>
+        inline size_t erase_key(const LKey& k)
         {
             auto ind = h(k);
             size_t bits = nh_data.get_neighborhood(ind);
@@ -518,10 +492,10 @@ namespace dysect
                 if (!(bits&1)) continue;
                 for (size_t ti = 0; ti < bucket_size; ++ti)
                 {
-                    auto tempk = table[i + ti].first;
+                    const auto& tempk = table[i + ti].first;
                     if ( tempk == k )
                     {
-                        table[i] = std::make_pair(0,0);
+                        table[i] = value_intern();
                         for (size_t tti = 0; tti < bucket_size; ++tti)
                         {
                             auto ttk = table[i+tti].first;
@@ -535,7 +509,16 @@ namespace dysect
             return 0;
         }
 
-    private:
+        // neighborhood bitsets are stored next to the table, both are
+        // overallocated (max_size cells/bytes)
+        inline void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_allocated += (capacity/bucket_size)*AugData_t::n_bytes;
+            s.bytes_reserved   = sizeof(*this) + max_size
+                                 + max_size*AugData_t::n_bytes;
+        }
+
         inline size_t index(size_t i) const
         { return size_t(double(bitmask & i) * factor) * bucket_size; }
         inline size_t mod  (size_t i) const
@@ -561,19 +544,19 @@ namespace dysect
 
             for (int i = osize; i >= 0; --i)
             {
-                auto current  = table[i];
+                auto current  = std::move(table[i]);
                 if (current.first)
                 {
                     table[i] = value_intern();
                     if (h(current.first) > size_t(i))
-                        insert(current);
+                        base_type::insert(std::move(current));
                     else
-                        buffer.push_back(current);
+                        buffer.push_back(std::move(current));
                 }
             }
             for (auto it = buffer.begin(); it != buffer.end(); ++it)
             {
-                insert(*it);
+                base_type::insert(std::move(*it));
             }
         }
 
@@ -586,7 +569,7 @@ namespace dysect
                 if (ind + nh_size > pos)
                 {
                     auto aug = nh_data.get_accessor(ind);
-                    table[i] = std::make_pair(0,0);
+                    table[i] = value_intern();
 
                     // Make sure, the same bucket does not store another element
                     // hashed to ind! Then delete the bit
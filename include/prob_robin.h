@@ -35,7 +35,11 @@ namespace dysect
         using mapped_type    = typename prob_traits<this_type>::mapped_type;
         using iterator       = typename base_type::iterator;
         using const_iterator = typename base_type::const_iterator;
+    private:
+        using value_intern   = typename base_type::value_intern;
+        using mapped_param_type = typename base_type::mapped_param_type;
 
+    public:
         prob_robin(size_type cap = 0      , double size_constraint = 1.1,
                   size_type /*dis_steps*/ = 0, size_type /*seed*/ = 0)
             : base_type(std::max<size_type>(cap, 500), size_constraint),
@@ -65,26 +69,25 @@ namespace dysect
         using base_type::make_iterator;
         using base_type::make_citerator;
 
-    public:
-
-        //specialized functions because of Robin Hood Hashing
-        inline std::pair<iterator, bool> insert(const key_type& k, const mapped_type& d)
-        {
-            return insert(std::make_pair(k,d));
-        }
-
-        inline std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type>& t)
+        //specialized insert because of Robin Hood Hashing (see prob_base)
+        template<class Make>
+        inline std::pair<iterator, bool> insert_with(const key_type& k, Make make)
         {
+            if (k == 0) return base_type::insert_zero(make);
             // using doubles makes the element order independent from the capacity
             // thus growing gets even easier
-            double ind     = dindex(hasher(t.first));
-            auto   current = t;
+            base_type::grow_if_full();
+            double ind     = dindex(hasher(k));
+            value_intern current;
+            // the new element is made where it is placed or swapped in first
+            // (then k cannot follow), later swaps move displaced elements
+            value_intern* pos = nullptr;
 
             for (size_type i = ind; ; ++i)
             {
-                auto temp  = table[i];
+                const auto& temp = table[i];
 
-                if ( temp.first == t.first )
+                if ( ! pos && temp.first == k )
                 {
                     return std::make_pair(make_iterator(&table[i]), false);
                 }
@@ -92,15 +95,22 @@ namespace dysect
                 {
                     if (i == capacity - 1)
                         return std::make_pair(base_type::end(), false);
-                    table[i] = current;
+                    if (pos) table[i] = std::move(current);
+                    else     table[i] = make();
                     inc_n();
                     pdistance = std::max<size_type>(pdistance, i-size_type(ind));
-                    return std::make_pair(make_iterator(&table[i]), true);
+                    return std::make_pair(make_iterator((pos) ? pos : &table[i]), true);
                 }
                 double tind = dindex(hasher(temp.first));
                 if ( tind > ind )
                 {
-                    std::swap(table[i], current);
+                    if (! pos)
+                    {
+                        pos      = &table[i];
+                        current  = std::move(table[i]);
+                        table[i] = make();
+                    }
+                    else std::swap(table[i], current);
                     pdistance = std::max<int>(pdistance, i-size_type(ind));
                     ind = tind;
                 }
@@ -108,13 +118,15 @@ namespace dysect
             return std::make_pair(base_type::end(), false);
         }
 
-        inline iterator find(const key_type& k)
+        // used by find and erase (see prob_base)
+        template<class LKey>
+        inline value_intern* find_ptr(const LKey& k) const
         {
             auto ind = h(k);
 
             for (size_type i = ind; i <= ind+pdistance; ++i)
             {
-                auto temp = table[i];
+                const auto& temp = table[i];
 
                 if ( temp.first == 0 )
                 {
@@ -122,39 +134,20 @@ namespace dysect
                 }
                 else if ( temp.first == k )
                 {
-                    return make_iterator(&table[i]);
+                    return &table[i];
                 }
             }
-            return base_type::end();
+            return nullptr;
         }
 
-        inline const_iterator find(const key_type& k) const
-        {
-            auto ind = h(k);
-
-            for (size_type i = ind; i <= ind+pdistance; ++i)
-            {
-                auto temp = table[i];
-
-                if ( temp.first == 0 )
-                {
-                    break;
-                }
-                else if ( temp.first == k )
-                {
-                    return make_citerator(&table[i]);
-                }
-            }
-            return base_type::cend();
-        }
-
-        inline size_type erase(const key_type& k)
+        template<class LKey>
+        inline size_type erase_key(const LKey& k)
         {
             auto ind = h(k);
 
             for (size_type i = ind; i <= ind+pdistance ; ++i)
             {
-                auto temp = table[i];
+                const auto& temp = table[i];
 
                 if ( temp.first == 0 )
                 {
@@ -170,7 +163,10 @@ namespace dysect
             return 0;
         }
 
-    private:
+        // the search bound is the probe distance (see stats() in prob_base)
+        inline void add_stats(table_stats& s) const
+        { s.max_probe = pdistance; }
+
         inline size_type index (size_type i) const
         { return double(bitmask & i) * factor; }
         inline double dindex(size_type i) const
@@ -198,14 +194,14 @@ namespace dysect
             size_type target_pos = 0;
             for (size_type i = 0; i < source.capacity; ++i)
             {
-                auto current = source.table[i];
+                auto& current = source.table[i];
                 if (!current.first) continue;
                 auto hash = h(current.first);
                 if (target_pos > hash)
                     distance   = std::max<size_type>(distance, target_pos - hash);
                 else
                     target_pos = hash;
-                table[target_pos++] = current;
+                table[target_pos++] = std::move(current);
             }
             return distance;
         }
@@ -224,7 +220,7 @@ namespace dysect
                 table[thole] = temp;
                 thole = i;
             }
-            table[thole] = std::make_pair(0,0);
+            table[thole] = value_intern();
         }
 
     public:
@@ -284,6 +280,7 @@ namespace dysect
         using const_iterator = typename base_type::const_iterator;
     private:
         using value_intern   = typename base_type::value_intern;
+        using mapped_param_type = typename base_type::mapped_param_type;
         static constexpr size_type max_size = 16ull << 30;
     public:
 
@@ -327,26 +324,25 @@ namespace dysect
         using base_type::make_iterator;
         using base_type::make_citerator;
 
-    public:
-
-        //specialized functions because of Robin Hood Hashing
-        inline std::pair<iterator, bool> insert(const key_type& k, const mapped_type& d)
-        {
-            return insert(std::make_pair(k,d));
-        }
-
-        inline std::pair<iterator, bool> insert(const std::pair<key_type, mapped_type>& t)
+        //specialized insert because of Robin Hood Hashing (see prob_base)
+        template<class Make>
+        inline std::pair<iterator, bool> insert_with(const key_type& k, Make make)
         {
+            if (k == 0) return base_type::insert_zero(make);
             // using doubles makes the element order independent from the capacity
             // thus growing gets even easier
-            double ind     = dindex(hasher(t.first));
-            auto   current = t;
+            base_type::grow_if_full();
+            double ind     = dindex(hasher(k));
+            value_intern current;
+            // the new element is made where it is placed or swapped in first
+            // (then k cannot follow), later swaps move displaced elements
+            value_intern* pos = nullptr;
 
             for (size_type i = ind; ; ++i)
             {
-                auto temp  = table[i];
+                const auto& temp = table[i];
 
-                if ( temp.first == t.first )
+                if ( ! pos && temp.first == k )
                 {
                     return std::make_pair(make_iterator(&table[i]), false);
                 }
@@ -354,15 +350,22 @@ namespace dysect
                 {
                     if (i == capacity - 1)
                         return std::make_pair(base_type::end(), false);
-                    table[i] = current;
+                    if (pos) table[i] = std::move(current);
+                    else     table[i] = make();
                     inc_n();
                     pdistance = std::max<size_type>(pdistance, i-size_type(ind));
-                    return std::make_pair(make_iterator(&table[i]), true);
+                    return std::make_pair(make_iterator((pos) ? pos : &table[i]), true);
                 }
                 double tind = dindex(hasher(temp.first));
                 if ( tind > ind )
                 {
-                    std::swap(table[i], current);
+                    if (! pos)
+                    {
+                        pos      = &table[i];
+                        current  = std::move(table[i]);
+                        table[i] = make();
+                    }
+                    else std::swap(table[i], current);
                     pdistance = std::max<int>(pdistance, i-size_type(ind));
                     ind = tind;
                 }
@@ -370,13 +373,15 @@ namespace dysect
             return std::make_pair(base_type::end(), false);
         }
 
-        inline iterator find(const key_type& k)
+        // used by find and erase (see prob_base)
+        template<class LKey>
+        inline value_intern* find_ptr(const LKey& k) const
         {
             auto ind = h(k);
 
             for (size_type i = ind; i <= ind+pdistance; ++i)
             {
-                auto temp = table[i];
+                const auto& temp = table[i];
 
                 if ( temp.first == 0 )
                 {
@@ -384,39 +389,20 @@ namespace dysect
                 }
                 else if ( temp.first == k )
                 {
-                    return make_iterator(&table[i]);
+                    return &table[i];
                 }
             }
-            return base_type::end();
+            return nullptr;
         }
 
-        inline const_iterator find(const key_type& k) const
-        {
-            auto ind = h(k);
-
-            for (size_type i = ind; i <= ind+pdistance; ++i)
-            {
-                auto temp = table[i];
-
-                if ( temp.first == 0 )
-                {
-                    break;
-                }
-                else if ( temp.first == k )
-                {
-                    return make_citerator(&table[i]);
-                }
-            }
-            return base_type::cend();
-        }
-
-        inline size_type erase(const key_type& k)
+        template<class LKey>
+        inline size_type erase_key(const LKey& k)
         {
             auto ind = h(k);
 
             for (size_type i = ind; i <= ind+pdistance ; ++i)
             {
-                auto temp = table[i];
+                const auto& temp = table[i];
 
                 if ( temp.first == 0 )
                 {
@@ -432,7 +418,14 @@ namespace dysect
             return 0;
         }
 
-    private:
+        // the search bound is the probe distance (see stats() in prob_base),
+        // the table is overallocated (max_size bytes)
+        inline void add_stats(table_stats& s) const
+        {
+            s.max_probe      = pdistance;
+            s.bytes_reserved = sizeof(*this) + max_size;
+        }
+
         inline size_type index (size_type i) const
         { return double(bitmask & i) * factor; }
         inline double dindex(size_type i) const
@@ -468,7 +461,7 @@ namespace dysect
             size_type distance   = 0;
             for (int i = index; i >= 0; --i)
             {
-                auto temp = table[i];
+                auto temp = std::move(table[i]);
 
                 if (!temp.first)
                     continue;
@@ -476,7 +469,7 @@ namespace dysect
                 table[i] = value_intern();
 
                 auto nind = h(temp.first);
-                if (nind < size_type(i)) { buffer.push_back(temp); continue; }
+                if (nind < size_type(i)) { buffer.push_back(std::move(temp)); continue; }
 
                 size_type t = nind;
 
@@ -488,7 +481,7 @@ namespace dysect
             }
             for (auto it = buffer.begin(); it != buffer.end(); it++)
             {
-                insert(*it);
+                base_type::insert(std::move(*it));
             }
 
         }
@@ -507,7 +500,7 @@ namespace dysect
                 table[thole] = temp;
                 thole = i;
             }
-            table[thole] = std::make_pair(0,0);
+            table[thole] = value_intern();
         }
 
     public:
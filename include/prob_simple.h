@@ -40,6 +40,9 @@ namespace dysect
         using size_type   = typename base_type::size_type;
         using key_type    = typename prob_traits<this_type>::key_type;
         using mapped_type = typename prob_traits<this_type>::mapped_type;
+    private:
+        using value_intern = typename base_type::value_intern;
+    public:
 
 
         prob_linear_doubling(size_type cap = 0, double = 1., size_type = 0)
@@ -86,10 +89,10 @@ namespace dysect
 
             for (size_type i = 0; i <= bitmask; ++i)
             {
-                auto temp = table[i];
+                auto& temp = table[i];
                 if (temp.first)
                 {
-                    ntable.insert(temp);
+                    ntable.insert(std::move(temp));
                 }
             }
 
@@ -131,6 +134,9 @@ namespace dysect
         using size_type   = typename base_type::size_type;
         using key_type    = typename prob_traits<this_type>::key_type;
         using mapped_type = typename prob_traits<this_type>::mapped_type;
+    private:
+        using value_intern = typename base_type::value_intern;
+    public:
 
         prob_linear(size_type cap = 0, double size_constraint = 1.1, size_type /*steps*/=0)
             : base_type(std::max<size_type>(cap, 500), size_constraint)
@@ -165,10 +171,10 @@ namespace dysect
 
             for (size_type i = 0; i < capacity; ++i)
             {
-                auto temp = table[i];
+                auto& temp = table[i];
                 if (temp.first)
                 {
-                    ntable.insert(temp);
+                    ntable.insert(std::move(temp));
                 }
             }
 
@@ -192,7 +198,7 @@ namespace dysect
                     thole = i;
                 }
             }
-            table[thole] = std::make_pair(0,0);
+            table[thole] = value_intern();
         }
     };
 
@@ -238,7 +244,7 @@ namespace dysect
         using key_type    = typename prob_traits<this_type>::key_type;
         using mapped_type = typename prob_traits<this_type>::mapped_type;
     private:
-        using value_intern = std::pair<key_type, mapped_type>;
+        using value_intern = typename base_type::value_intern;
 
         static constexpr size_type max_size = 16ull << 30;
 
@@ -281,6 +287,13 @@ namespace dysect
         inline size_type index(size_type i) const { return (bitmask & i)*factor; }
         inline size_type mod(size_type i)   const { return i; }
 
+        // the table is overallocated (max_size bytes)
+        inline void add_stats(table_stats& s) const
+        {
+            base_type::add_stats(s);
+            s.bytes_reserved = sizeof(*this) + max_size;
+        }
+
     public:
         using base_type::insert;
 
@@ -305,23 +318,23 @@ namespace dysect
 
             for (int i = capacity - 1; i >= 0; --i)
             {
-                auto temp = table[i];
+                auto temp = std::move(table[i]);
 
                 if (temp.first)
                 {
                     table[i] = value_intern();
                     auto ind = h(temp.first);
                     if (ind >= size_t(i))
-                        insert(temp);
+                        insert(std::move(temp));
                     else
-                        buffer.push_back(temp);
+                        buffer.push_back(std::move(temp));
                 }
                 else if (! buffer.empty())
                 {
                     bla = std::max(bla, buffer.size());
                     for (auto it = buffer.begin(); it != buffer.end(); it++)
                     {
-                        insert(*it);
+                        insert(std::move(*it));
                     }
                     buffer.clear();
                 }
@@ -332,7 +345,7 @@ namespace dysect
                 bla = std::max(bla, buffer.size());
                 for (auto it = buffer.begin(); it != buffer.end(); it++)
                 {
-                    insert(*it);
+                    insert(std::move(*it));
                 }
                 buffer.clear();
             }
@@ -355,7 +368,7 @@ namespace dysect
                     thole = i;
                 }
             }
-            table[thole] = std::make_pair(0,0);
+            table[thole] = value_intern();
         }
 
     public:
@@ -0,0 +1,67 @@
+#pragma once
+
+/*******************************************************************************
+ * include/table_stats.h
+ *
+ * table_stats is a snapshot of the memory usage and the fill state of a
+ * table, it is returned by stats() of all cuckoo and probing tables.
+ * Unlike print_init_data and the malloc_count build, it can be used at
+ * runtime, e.g. to check that the size constraint holds.
+ *
+ * Memory counts the table object and its element storage (buckets or
+ * cells, neighborhood data), not memory owned by the elements.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+namespace dysect
+{
+
+    struct subtable_stats
+    {
+        size_t buckets;
+        size_t capacity; // slots
+        size_t elements;
+    };
+
+    struct table_stats
+    {
+        size_t elements        = 0;
+        size_t capacity        = 0; // slots, as counted by the table
+        size_t element_bytes   = 0; // size of one stored element
+        size_t bytes_allocated = 0; // memory in use
+        size_t bytes_reserved  = 0; // including overallocated memory
+                                    // (inplace variants)
+
+        // probing tables: largest distance between an element and its
+        // hashed cell (robin: the search bound pdistance)
+        size_t max_probe       = 0;
+
+        // cuckoo tables: stashed elements (included in elements)
+        size_t stashed         = 0;
+
+        // cuckoo tables: one entry per subtable (tl for DySECT), and
+        // bucket_fill[i] = number of buckets holding i elements
+        std::vector<subtable_stats> subtables;
+        std::vector<size_t>         bucket_fill;
+
+        double load() const
+        { return (capacity) ? double(elements) / double(capacity) : 0.; }
+
+        // allocated memory relative to the memory of the elements, this
+        // is bounded by the size constraint (alpha) of the table
+        double size_factor() const
+        {
+            return (elements) ? double(bytes_allocated)
+                                / double(elements * element_bytes) : 0.;
+        }
+    };
+
+} // namespace dysect
@@ -0,0 +1,197 @@
+#pragma once
+
+/*******************************************************************************
+ * include/tag_bucket.h
+ *
+ * tag_bucket is a bucket variant, that stores an 8 bit tag (taken from the
+ * hashed value) for each slot. Lookups compare all tags at once (SWAR) and
+ * only compare full keys on a tag match. This mostly helps unsuccessful
+ * lookups and keys that are expensive to compare. Like bucket, all elements
+ * are stored at the beginning of the bucket, tag 0 marks an empty slot.
+ *
+ * Use it through cuckoo_config<..., tag_bucket>.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "element.h"
+
+namespace dysect
+{
+
+    template<class K, class D, size_t BS = 4>
+    class tag_bucket
+    {
+    public:
+        using key_type         = K;
+        using mapped_type      = D;
+        using value_intern     = typename element_traits<K,D>::value_intern;
+        static constexpr size_t bs = BS;
+        // empty slots are marked by their tags (any key can be stored)
+        static constexpr bool empty_key = false;
+
+    private:
+        static constexpr size_t   n_words = (BS+7)/8;
+        static constexpr uint64_t ones    = 0x0101010101010101ull;
+        static constexpr uint64_t low7    = 0x7F7F7F7F7F7F7F7Full;
+
+    public:
+        tag_bucket()
+        {
+            for (size_t i = 0; i < n_words; ++i)
+                tags[i] = 0;
+            for (size_t i = 0; i < BS; ++i)
+                elements[i] = value_intern();
+        }
+        tag_bucket(const tag_bucket& rhs) = default;
+        tag_bucket& operator=(const tag_bucket& rhs) = default;
+
+        template<class LKey, class Hashed>
+        value_intern*       find_ptr  (const LKey& k, const Hashed& h);
+        template<class LKey, class Hashed>
+        const value_intern* find_ptr  (const LKey& k, const Hashed& h) const;
+        template<class Hashed>
+        std::pair<int, value_intern*> probe_ptr(const key_type& k, const Hashed& h);
+        template<class Hashed>
+        value_intern*       insert_ptr(value_intern t, const Hashed& h);
+        template<class LKey, class Hashed>
+        bool                remove    (const LKey& k, const Hashed& h);
+        template<class Hashed>
+        value_intern        replace   (const size_t i, value_intern t, const Hashed& h);
+        void                remove_at (const size_t i);
+
+        bool         space   () const { return !tag(BS-1); }
+        value_intern get     (const size_t i) const { return elements[i]; }
+        bool         occupied(const size_t i) const { return tag(i); }
+        size_t       size    () const;
+
+        uint64_t     tags[n_words]; // tag of slot i is byte i
+        value_intern elements[BS];
+
+    private:
+        inline uint8_t  tag(size_t i) const
+        { return reinterpret_cast<const uint8_t*>(tags)[i]; }
+        inline void     set_tag(size_t i, uint8_t t)
+        { reinterpret_cast<uint8_t*>(tags)[i] = t; }
+
+        // highest bit of each byte is set iff the byte is zero
+        static inline uint64_t zero_bytes(uint64_t x)
+        { return ~(((x & low7) + low7) | x | low7); }
+
+        template<class LKey>
+        inline size_t   find_index(const LKey& k, uint8_t t) const;
+    };
+
+
+
+    template<class K, class D, size_t BS> template<class LKey>
+    inline size_t tag_bucket<K,D,BS>::find_index(const LKey& k, uint8_t t) const
+    {
+        const uint64_t pattern = ones * t;
+        for (size_t w = 0; w < n_words; ++w)
+        {
+            // the tag is never 0, therefore, padding bytes cannot match
+            uint64_t match = zero_bytes(tags[w] ^ pattern);
+            while (match)
+            {
+                size_t i = (w << 3) + (__builtin_ctzll(match) >> 3);
+                if (elements[i].first == k) return i;
+                match &= match - 1;
+            }
+        }
+        return BS;
+    }
+
+    template<class K, class D, size_t BS>
+    inline size_t tag_bucket<K,D,BS>::size() const
+    {
+        for (size_t w = 0; w < n_words; ++w)
+        {
+            uint64_t empty = zero_bytes(tags[w]);
+            if (empty)
+            {
+                size_t i = (w << 3) + (__builtin_ctzll(empty) >> 3);
+                return (i < BS) ? i : BS;
+            }
+        }
+        return BS;
+    }
+
+    template<class K, class D, size_t BS> template<class LKey, class Hashed>
+    inline typename tag_bucket<K,D,BS>::value_intern*
+    tag_bucket<K,D,BS>::find_ptr(const LKey& k, const Hashed& h)
+    {
+        size_t i = find_index(k, h.tag());
+        return (i < BS) ? &elements[i] : nullptr;
+    }
+
+    template<class K, class D, size_t BS> template<class LKey, class Hashed>
+    inline const typename tag_bucket<K,D,BS>::value_intern*
+    tag_bucket<K,D,BS>::find_ptr(const LKey& k, const Hashed& h) const
+    {
+        size_t i = find_index(k, h.tag());
+        return (i < BS) ? &elements[i] : nullptr;
+    }
+
+    template<class K, class D, size_t BS> template<class Hashed>
+    inline std::pair<int, typename tag_bucket<K,D,BS>::value_intern*>
+    tag_bucket<K,D,BS>::probe_ptr(const key_type& k, const Hashed& h)
+    {
+        size_t i = find_index(k, h.tag());
+        if (i < BS) return std::make_pair(-1, &elements[i]);
+        size_t j = size();
+        if (j < BS) return std::make_pair(int(BS - j), &elements[j]);
+        return std::make_pair(0, nullptr);
+    }
+
+    template<class K, class D, size_t BS> template<class Hashed>
+    inline typename tag_bucket<K,D,BS>::value_intern*
+    tag_bucket<K,D,BS>::insert_ptr(value_intern t, const Hashed& h)
+    {
+        size_t i = size();
+        if (i == BS) return nullptr;
+
+        elements[i] = std::move(t);
+        set_tag(i, h.tag());
+        return &elements[i];
+    }
+
+    template<class K, class D, size_t BS> template<class LKey, class Hashed>
+    inline bool tag_bucket<K,D,BS>::remove(const LKey& k, const Hashed& h)
+    {
+        size_t i = find_index(k, h.tag());
+        if (i == BS) return false;
+
+        remove_at(i);
+        return true;
+    }
+
+    template<class K, class D, size_t BS>
+    inline void tag_bucket<K,D,BS>::remove_at(const size_t i)
+    {
+        size_t j = size() - 1;
+        elements[i] = std::move(elements[j]);
+        set_tag(i, tag(j));
+        elements[j] = value_intern();
+        set_tag(j, 0);
+    }
+
+    template<class K, class D, size_t BS> template<class Hashed>
+    inline typename tag_bucket<K,D,BS>::value_intern
+    tag_bucket<K,D,BS>::replace(const size_t i, value_intern t, const Hashed& h)
+    {
+        auto temp   = std::move(elements[i]);
+        elements[i] = std::move(t);
+        set_tag(i, h.tag());
+        return temp;
+    }
+
+} // namespace dysect
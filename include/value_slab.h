@@ -0,0 +1,349 @@
+#pragma once
+
+/*******************************************************************************
+ * include/value_slab.h
+ *
+ * value_slab_adapter stores the mapped values of a table in a slab
+ * allocator (value_slab) owned by the table.  The table itself only
+ * stores the key and a 32 bit handle, this is useful for large mapped
+ * types.
+ *
+ * Part of Project DySECT - https://github.com/TooBiased/DySECT.git
+ *
+ * Copyright (C) 2017 Tobias Maier <t.maier@kit.edu>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cache_line.h"
+#include "cuckoo_dysect.h"
+
+namespace dysect
+{
+
+    // VALUE SLAB **************************************************************
+
+    // values are stored in chunks of 2^ChunkBits values, chunks are never
+    // reallocated, freed handles are reused.  Chunks are uninitialized
+    // memory, values are constructed in place by allocate and destroyed by
+    // release (or by the destructor)
+    template<class T, size_t ChunkBits = 12>
+    class value_slab
+    {
+    public:
+        using handle_type = uint32_t;
+        static constexpr size_t chunk_size  = size_t(1) << ChunkBits;
+        static constexpr size_t max_handles =
+            size_t(std::numeric_limits<handle_type>::max()) + 1;
+
+        value_slab() : used(0) { }
+        ~value_slab();
+        value_slab(const value_slab&) = delete;
+        value_slab& operator=(const value_slab&) = delete;
+        value_slab(value_slab&& rhs)
+            : used(rhs.used), chunks(std::move(rhs.chunks)),
+              free_handles(std::move(rhs.free_handles))
+        { rhs.used = 0; }
+        // the values of *this are destroyed with rhs
+        value_slab& operator=(value_slab&& rhs)
+        {
+            std::swap(used, rhs.used);
+            std::swap(chunks, rhs.chunks);
+            std::swap(free_handles, rhs.free_handles);
+            return *this;
+        }
+
+        template<class... Args>
+        inline handle_type allocate(Args&&... args);
+        inline void        release (handle_type h);
+
+        inline T&       operator[](handle_type h)
+        { return chunks[h >> ChunkBits][h & mask]; }
+        inline const T& operator[](handle_type h) const
+        { return chunks[h >> ChunkBits][h & mask]; }
+
+        inline size_t size()     const { return used - free_handles.size(); }
+        inline size_t capacity() const { return chunks.size() * chunk_size; }
+
+    private:
+        static constexpr size_t mask = chunk_size - 1;
+
+        size_t                         used;
+        std::vector<aligned_array<T> > chunks;
+        std::vector<handle_type>       free_handles;
+    };
+
+    template<class T, size_t ChunkBits>
+    value_slab<T,ChunkBits>::~value_slab()
+    {
+        if (std::is_trivially_destructible<T>::value) return;
+
+        std::vector<bool> freed(used, false);
+        for (auto h : free_handles) freed[h] = true;
+        for (size_t h = 0; h < used; ++h)
+            if (! freed[h]) (*this)[h].~T();
+    }
+
+    template<class T, size_t ChunkBits> template<class... Args>
+    inline typename value_slab<T,ChunkBits>::handle_type
+    value_slab<T,ChunkBits>::allocate(Args&&... args)
+    {
+        handle_type h;
+        if (! free_handles.empty())
+        {
+            h = free_handles.back();
+            free_handles.pop_back();
+        }
+        else
+        {
+            if (used == capacity())
+            {
+                if (used >= max_handles) throw std::length_error("value_slab is full");
+                chunks.push_back(make_aligned_buffer<T>(chunk_size*sizeof(T)));
+            }
+            h = used++;
+        }
+
+        // no handle is lost if the constructor throws
+        try { new (&(*this)[h]) T(std::forward<Args>(args)...); }
+        catch (...) { free_handles.push_back(h); throw; }
+        return h;
+    }
+
+    template<class T, size_t ChunkBits>
+    inline void value_slab<T,ChunkBits>::release(handle_type h)
+    {
+        (*this)[h].~T();
+        free_handles.push_back(h);
+    }
+
+
+
+    // ADAPTER *****************************************************************
+
+    // Table has to be a map from key_type to value_slab<D>::handle_type,
+    // displacements only move handles, values never move (references
+    // returned by at() and operator[] stay valid while the table grows)
+    template<class Table, class D>
+    class value_slab_adapter
+    {
+    private:
+        using this_type   = value_slab_adapter<Table, D>;
+        using table_type  = Table;
+        using slab_type   = value_slab<D>;
+        using handle_type = typename slab_type::handle_type;
+
+        static_assert(std::is_same<typename table_type::mapped_type, handle_type>::value,
+                      "value_slab_adapter needs a table storing value_slab handles");
+
+        template<class TableIterator, bool is_const>
+        class slab_iterator;
+
+    public:
+        using key_type       = typename table_type::key_type;
+        using mapped_type    = D;
+        using value_type     = std::pair<const key_type, mapped_type>;
+        using size_type      = size_t;
+        using iterator       = slab_iterator<typename table_type::iterator,       false>;
+        using const_iterator = slab_iterator<typename table_type::const_iterator, true >;
+        using insert_return_type = std::pair<iterator, bool>;
+
+        value_slab_adapter(size_type cap = 0, double size_constraint = 1.1,
+                           size_type dis_steps = 0, size_type seed = 0)
+            : table(cap, size_constraint, dis_steps, seed)
+        { }
+        value_slab_adapter(const value_slab_adapter&) = delete;
+        value_slab_adapter& operator=(const value_slab_adapter&) = delete;
+        value_slab_adapter(value_slab_adapter&&) = default;
+        value_slab_adapter& operator=(value_slab_adapter&&) = default;
+
+    private:
+        table_type table;
+        slab_type  slab;
+
+    public:
+        // Basic Hash Table Functionality ******************************************
+        inline iterator find(const key_type& k)
+        { return iterator(table.find(k), &slab); }
+
+        inline const_iterator find(const key_type& k) const
+        { return const_iterator(table.find(k), &slab); }
+
+        inline insert_return_type insert(const key_type& k, const mapped_type& d)
+        { return try_emplace(k, d); }
+
+        inline insert_return_type insert(const value_type& t)
+        { return insert(t.first, t.second); }
+
+        template<class... Args>
+        inline insert_return_type try_emplace(const key_type& k, Args&&... args)
+        {
+            // the value is only constructed, if the key is new
+            auto r = table.insert(k, handle_type(0));
+            if (r.second) r.first->second = allocate_new(k, std::forward<Args>(args)...);
+            return std::make_pair(iterator(r.first, &slab), r.second);
+        }
+
+        // values are constructed in the slab, therefore, emplace takes
+        // the key and the constructor arguments of the value
+        template<class... Args>
+        inline insert_return_type emplace(const key_type& k, Args&&... args)
+        { return try_emplace(k, std::forward<Args>(args)...); }
+
+        template<class M>
+        inline insert_return_type insert_or_assign(const key_type& k, M&& obj)
+        {
+            auto r = table.insert(k, handle_type(0));
+            if (r.second) r.first->second = allocate_new(k, std::forward<M>(obj));
+            else if (r.first != table.end()) slab[r.first->second] = std::forward<M>(obj);
+            return std::make_pair(iterator(r.first, &slab), r.second);
+        }
+
+        template<class F>
+        inline insert_return_type upsert(const key_type& k, const mapped_type& init, F fn)
+        {
+            auto r = table.insert(k, handle_type(0));
+            if (r.second) r.first->second = allocate_new(k, init);
+            else if (r.first != table.end()) fn(slab[r.first->second]);
+            return std::make_pair(iterator(r.first, &slab), r.second);
+        }
+
+        inline insert_return_type fetch_add(const key_type& k, const mapped_type& d)
+        { return upsert(k, d, [&d](mapped_type& v) { v += d; }); }
+
+        // k is hashed once (see cuckoo_base)
+        inline size_type erase(const key_type& k)
+        {
+            auto hash = table.hash(k);
+            auto it   = table.find_hashed(k, hash);
+            if (it == table.end()) return 0;
+            handle_type h = it->second;
+            table.erase_hashed(k, hash);
+            slab.release(h);
+            return 1;
+        }
+
+        // Easy use Accessors for std compliance ***********************************
+        inline iterator       begin ()       { return iterator(table.begin(), &slab); }
+        inline const_iterator begin () const { return cbegin(); }
+        inline const_iterator cbegin() const { return const_iterator(table.cbegin(), &slab); }
+        inline iterator       end   ()       { return iterator(table.end(), &slab); }
+        inline const_iterator end   () const { return cend(); }
+        inline const_iterator cend  () const { return const_iterator(table.cend(), &slab); }
+
+        inline mapped_type& at(const key_type& k)
+        {
+            auto it = table.find(k);
+            if (it == table.end()) throw std::out_of_range("cannot find key");
+            return slab[it->second];
+        }
+
+        inline const mapped_type& at(const key_type& k) const
+        {
+            auto it = table.find(k);
+            if (it == table.cend()) throw std::out_of_range("cannot find key");
+            return slab[it->second];
+        }
+
+        inline mapped_type& operator[](const key_type& k)
+        { return (*try_emplace(k).first).second; }
+
+        inline size_type count(const key_type& k) const { return table.count(k); }
+
+        inline size_type empty() const { return table.empty(); }
+        inline size_type size()  const { return table.size(); }
+
+        // only if the table supports it (e.g. cuckoo_dysect)
+        inline void reserve(size_type cap) { table.reserve(cap); }
+
+        // the slab is counted as allocated memory, element_bytes remains the
+        // size of a table element (key and handle)
+        inline table_stats stats() const
+        {
+            auto s = table.stats();
+            s.bytes_allocated += sizeof(*this) - sizeof(table_type)
+                                 + slab.capacity()*sizeof(mapped_type);
+            s.bytes_reserved  += sizeof(*this) - sizeof(table_type)
+                                 + slab.capacity()*sizeof(mapped_type);
+            return s;
+        }
+
+        // auxiliary functions for testing *****************************************
+        inline static void print_init_header(std::ostream& out)
+        { table_type::print_init_header(out); }
+
+        inline void print_init_data(std::ostream& out)
+        { table.print_init_data(out); }
+
+    private:
+        // allocates the value of the new key k (inserted with handle 0),
+        // k is erased again if the allocation or the value constructor throws
+        template<class... Args>
+        inline handle_type allocate_new(const key_type& k, Args&&... args)
+        {
+            try { return slab.allocate(std::forward<Args>(args)...); }
+            catch (...) { table.erase(k); throw; }
+        }
+
+        // Iterator ****************************************************************
+        // dereferences to a pair of references (key in the table, value in
+        // the slab), operator-> returns a proxy holding this pair
+        template<class TableIterator, bool is_const>
+        class slab_iterator
+        {
+        private:
+            using slab_pointer = typename std::conditional<is_const,
+                                     const slab_type*, slab_type*>::type;
+            using cmapped_type = typename std::conditional<is_const,
+                                     const mapped_type, mapped_type>::type;
+
+        public:
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = typename this_type::value_type;
+            using reference         = std::pair<const key_type&, cmapped_type&>;
+            using iterator_category = std::forward_iterator_tag;
+
+            struct pointer
+            {
+                reference  ref;
+                reference* operator->() { return &ref; }
+            };
+
+            slab_iterator(const TableIterator& it, slab_pointer slab)
+                : it(it), slab(slab) { }
+
+            slab_iterator& operator++()    { it++; return *this; }
+            slab_iterator& operator++(int) { it++; return *this; }
+
+            reference operator* () const
+            { return reference(it->first, (*slab)[it->second]); }
+            pointer   operator->() const
+            { return pointer{**this}; }
+
+            bool operator==(const slab_iterator& rhs) const { return it == rhs.it; }
+            bool operator!=(const slab_iterator& rhs) const { return it != rhs.it; }
+
+        private:
+            TableIterator it;
+            slab_pointer  slab;
+        };
+    };
+
+
+
+    // DySECT with its values in a value_slab
+    template<class K, class D, class HF = std::hash<K>,
+             class Conf = cuckoo_config<> >
+    using cuckoo_dysect_slab =
+        value_slab_adapter<cuckoo_dysect<K, typename value_slab<D>::handle_type, HF, Conf>, D>;
+
+} // namespace dysect
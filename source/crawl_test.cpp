@@ -110,13 +110,13 @@ struct Test
                         if (j0 < j)
                         {
                             size_t key = XXH64(j0, j-j0, hseed);
-                            auto e = table.insert(key, 1);
+                            auto e = table.fetch_add(key, 1);
                             if (e.second) ++individual;
                             else
                             {
                                 if (e.first != table.end())
                                 {
-                                    size_t a = ++((*e.first).second);
+                                    size_t a = (*e.first).second;
                                     max = (a < max) ? max : a;
                                     ++contained;
                                 }
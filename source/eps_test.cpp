@@ -78,6 +78,14 @@ struct Test
         out << std::endl;
     }
 
+    // the returned iterator has to point to the inserted element (also
+    // if the displacement moved it again)
+    static inline bool insert_check(Table& table, size_t k, size_t d)
+    {
+        auto r = table.insert(k, d);
+        return r.second && (*r.first).first == k;
+    }
+
     void prepare_find_keys(size_t* fikeys, size_t* inkeys, size_t fis, size_t ins)
     {
         std::uniform_int_distribution<uint64_t> pdis(1,ins);
@@ -135,13 +143,13 @@ struct Test
             {
                 for (; j < nxt_blk; ++j)
                 {
-                    if (!table.insert(inkeys[j], j).second) ++in_errors;
+                    if (!insert_check(table, inkeys[j], j)) ++in_errors;
                 }
 
                 auto t1 = std::chrono::high_resolution_clock::now();
                 for ( ; j < nxt_blk+win; ++j)
                 {
-                    if (!table.insert(inkeys[j], j).second) ++in_errors;
+                    if (!insert_check(table, inkeys[j], j)) ++in_errors;
                 }
                 auto t2 = std::chrono::high_resolution_clock::now();
                 for (size_t k = 0; k < win; ++k)
@@ -43,6 +43,12 @@
 #define HASHTYPE dysect::cuckoo_dysect_inplace
 #endif // DYSECT_INPLACE
 
+#ifdef DYSECT_SLAB
+#define MULTI
+#include "include/value_slab.h"
+#define HASHTYPE dysect::cuckoo_dysect_slab
+#endif // DYSECT_SLAB
+
 
 
 // cuckoo_independent_2lvl table
@@ -164,9 +170,21 @@ struct Chooser
         if      (c.boolArg("-bfs"))
             return executeD<Functor, HistCount, dysect::cuckoo_displacement::bfs>
                 ( c, std::forward<Types>(param)...);
+        else if (c.boolArg("-fbfs"))
+            return executeD<Functor, HistCount, dysect::cuckoo_displacement::bfs_frontier>
+                ( c, std::forward<Types>(param)...);
         else if (c.boolArg("-rwalk"))
             return executeD<Functor, HistCount, dysect::cuckoo_displacement::random_walk>
                 ( c, std::forward<Types>(param)...);
+        else if (c.boolArg("-lookahead"))
+            return executeD<Functor, HistCount, dysect::cuckoo_displacement::lookahead>
+                ( c, std::forward<Types>(param)...);
+        else if (c.boolArg("-adaptive"))
+            return executeD<Functor, HistCount, dysect::cuckoo_displacement::adaptive>
+                ( c, std::forward<Types>(param)...);
+        else if (c.boolArg("-lwalk"))
+            return executeD<Functor, HistCount, dysect::cuckoo_displacement::load_walk>
+                ( c, std::forward<Types>(param)...);
 
         std::cout << "ERROR: choose displacement Strategy (use triv)" << std::endl;
         return executeD<Functor, HistCount, dysect::cuckoo_displacement::trivial>
@@ -214,6 +232,10 @@ struct Chooser
         auto bs = c.intArg("-bs", dysect::cuckoo_config<>::bs);
         switch (bs)
         {
+#if !defined(CUCKOO_OVERLAP) && !defined(CUCKOO_OVERLAP_INPLACE) && !defined(CUCKOO_INDEPENDENT_2LVL)
+        case 0: // fill cache lines (depends on key and data size)
+            return executeDTB<Functor, HistCount, Displacer, TL,  0> (c, std::forward<Types>(param)...);
+#endif
         case 4:
             return executeDTB<Functor, HistCount, Displacer, TL,  4> (c, std::forward<Types>(param)...);
         // case 6:
@@ -3,6 +3,11 @@
  *
  * Some hash functions -- the used hash function is chosen at compile time
  *
+ * A hash function can define hash_n(keys, n, out) to hash many keys at
+ * once, murmur2 and multshift have AVX2 kernels (-DDYSECT_AVX2=ON),
+ * otherwise the tables call operator() in a loop (see batch_hash in
+ * include/hasher.h).
+ *
  * Part of Project growt - https://github.com/TooBiased/growt.git
  *
  * Copyright (C) 2015-2016 Tobias Maier <t.maier@kit.edu>
@@ -14,10 +19,42 @@
 #define HASHFCT_H
 
 #include <stdint.h>
+#include <stddef.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
 
-#if (! (defined(CRC)     || \
-        defined(MURMUR2) || \
-        defined(MURMUR3) || \
+// AVX2 has no 64 bit multiplication, both halves of the 128 bit product
+// are composed from 32x32 bit products (mul_epu32)
+static inline __m256i mullo64_avx2(__m256i a, __m256i b)
+{
+    __m256i lo    = _mm256_mul_epu32(a, b);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                     _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+static inline __m256i mulhi64_avx2(__m256i a, __m256i b)
+{
+    const __m256i lo32 = _mm256_set1_epi64x(0xffffffffull);
+    __m256i a_hi = _mm256_srli_epi64(a, 32);
+    __m256i b_hi = _mm256_srli_epi64(b, 32);
+    __m256i ll   = _mm256_mul_epu32(a   , b   );
+    __m256i lh   = _mm256_mul_epu32(a   , b_hi);
+    __m256i hl   = _mm256_mul_epu32(a_hi, b   );
+    __m256i hh   = _mm256_mul_epu32(a_hi, b_hi);
+    // neither sum can overflow
+    __m256i mid0 = _mm256_add_epi64(lh, _mm256_srli_epi64(ll, 32));
+    __m256i mid1 = _mm256_add_epi64(hl, _mm256_and_si256(mid0, lo32));
+    return _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid0, 32)),
+                            _mm256_srli_epi64(mid1, 32));
+}
+#endif // __AVX2__
+
+#if (! (defined(CRC)       || \
+        defined(MURMUR2)   || \
+        defined(MURMUR3)   || \
+        defined(MULTSHIFT) || \
         defined(XXHASH)) )
 #define MURMUR2
 #endif // NO HASH DEFINED
@@ -103,10 +140,92 @@ struct murmur2_hasher
         auto local = k;
         return MurmurHash64A(&local, 8, seed);
     }
+
+#ifdef __AVX2__
+    // MurmurHash64A of four 8 byte keys at once (same results as operator())
+    inline void hash_n(const uint64_t* k, size_t n, uint64_t* out) const
+    {
+        const uint64_t m  = 0xc6a4a7935bd1e995;
+        const __m256i  vm = _mm256_set1_epi64x(m);
+        const __m256i  h0 = _mm256_set1_epi64x(uint64_t((unsigned int)seed) ^ (8 * m));
+
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k+i));
+            x = mullo64_avx2(x, vm);
+            x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 47));
+            x = mullo64_avx2(x, vm);
+
+            __m256i h = mullo64_avx2(_mm256_xor_si256(h0, x), vm);
+            h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 47));
+            h = mullo64_avx2(h, vm);
+            h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 47));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i), h);
+        }
+        for ( ; i < n; ++i) out[i] = (*this)(k[i]);
+    }
+#endif // __AVX2__
 };
 #endif // MURMUR2
 
 
+#ifdef MULTSHIFT
+#define HASHFCT multshift_hasher
+// multiply-shift with a 128 bit multiplier a:  h(k) = ((a * k) >> 64) + b
+// (mod 2^64), cheap and universal, but less robust than the other functions
+struct multshift_hasher
+{
+    multshift_hasher(size_t s = 1203989050u)
+        : a_lo(mix(s)), a_hi(mix(a_lo)), b(mix(a_hi))
+    { }
+
+    static constexpr size_t significant_digits = 64;
+    //const
+    uint64_t a_lo;
+    //const
+    uint64_t a_hi;
+    //const
+    uint64_t b;
+
+    // splitmix64 finalizer, used to derive the multipliers from the seed
+    static inline uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ull;
+        x  = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x  = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    inline uint64_t operator()(const uint64_t k) const
+    {
+        return a_hi * k + uint64_t((__uint128_t(a_lo) * k) >> 64) + b;
+    }
+
+#ifdef __AVX2__
+    // four keys at once (same results as operator())
+    inline void hash_n(const uint64_t* k, size_t n, uint64_t* out) const
+    {
+        const __m256i vlo = _mm256_set1_epi64x(a_lo);
+        const __m256i vhi = _mm256_set1_epi64x(a_hi);
+        const __m256i vb  = _mm256_set1_epi64x(b);
+
+        size_t i = 0;
+        for ( ; i + 4 <= n; i += 4)
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k+i));
+            __m256i h = _mm256_add_epi64(mullo64_avx2(vhi, x),
+                                         mulhi64_avx2(vlo, x));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out+i),
+                                _mm256_add_epi64(h, vb));
+        }
+        for ( ; i < n; ++i) out[i] = (*this)(k[i]);
+    }
+#endif // __AVX2__
+};
+#endif // MULTSHIFT
+
+
 #ifdef MURMUR3
 // We include the cpp to avoid generating another compile unit
 #include "MurmurHash3.cpp"